@@ -0,0 +1,279 @@
+#include "bk4819_sim.h"
+#include "../src/driver/bk4819-regs.h"
+#include "../src/settings.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+SimScene gSimScene = {.floorDbm = -125};
+SimStats gSimStats;
+
+static uint16_t regs[128];
+static uint64_t tunedAtUs;
+static uint32_t settleUs = BK4819SIM_SETTLE_US;
+static uint32_t lockFromF; // откуда начался текущий захват
+static uint32_t rng = 1;
+static uint64_t fcStartUs; // запуск частотомера (REG_32 bit 0)
+static bool fcLatched;     // отсчёт готов и держится до перезапуска
+static uint32_t fcResult;
+
+// Полуширина полосы по полю RF регистра 0x43 (10 Hz)
+static const uint16_t RF_HALF_BW[8] = {
+    150, 300, 400, 500, 625, 750, 1000, 1250,
+};
+
+static int16_t jitter(int16_t span) {
+  rng = rng * 1103515245u + 12345u;
+  return (int16_t)((rng >> 16) % (2 * span + 1)) - span;
+}
+
+static uint32_t tunedF(void) {
+  return (((uint32_t)regs[BK4819_REG_39] << 16) | regs[BK4819_REG_38]) -
+         gSettings.freqCorrection;
+}
+
+static bool vcoOn(void) {
+  return (regs[BK4819_REG_30] & BK4819_REG_30_ENABLE_PLL_VCO) ==
+         BK4819_REG_30_ENABLE_PLL_VCO;
+}
+
+static bool txActive(const SimTx *tx, uint32_t nowMs) {
+  if (tx->onMs == 0)
+    return true;
+  return nowMs % (tx->onMs + tx->offMs) < tx->onMs;
+}
+
+// Уровень на входе с учётом скатов фильтра: -20 dB на каждую полуполосу
+static int16_t sceneDbm(uint32_t f) {
+  uint32_t half = RF_HALF_BW[(regs[BK4819_REG_43] >> 12) & 7];
+  uint32_t nowMs = HOST_NowUs() / 1000;
+  int16_t best = gSimScene.floorDbm;
+
+  for (uint8_t i = 0; i < gSimScene.txCount; ++i) {
+    const SimTx *tx = &gSimScene.tx[i];
+    if (!txActive(tx, nowMs))
+      continue;
+    uint32_t d = tx->f > f ? tx->f - f : f - tx->f;
+    int32_t lvl = tx->dbm;
+    if (d > half)
+      lvl -= (int32_t)(d - half) * 20 / half;
+    if (lvl > best)
+      best = lvl;
+  }
+  return best;
+}
+
+// Грубая модель: шаг в пределах канала ловится почти сразу,
+// скачок на 10 МГц и больше — за полное время захвата
+static uint32_t settleTime(uint32_t jump) {
+  uint32_t us = BK4819SIM_SETTLE_MIN_US + jump / 800;
+  return us > BK4819SIM_SETTLE_US ? BK4819SIM_SETTLE_US : us;
+}
+
+static int16_t measuredDbm(void) {
+  int16_t off = gSimScene.floorDbm - BK4819SIM_VCO_OFF_DB;
+  if (!vcoOn())
+    return off;
+
+  int16_t dbm = sceneDbm(tunedF());
+  uint64_t since = HOST_NowUs() - tunedAtUs;
+  if (since < settleUs) {
+    // PLL ещё не захватил: уровень ползёт от "VCO выключен" к настоящему
+    gSimStats.unsettled++;
+    dbm = off + (int32_t)(dbm - off) * since / settleUs;
+  }
+  return dbm + jitter(1);
+}
+
+// Частотомер: сильнейшая несущая в эфире, иначе случайный отсчёт по шуму.
+// Окно счёта — 200 мс << поле времени REG_32
+static bool fcResultReady(void) {
+  if (!(regs[BK4819_REG_32] & 1))
+    return false;
+  if (fcLatched)
+    return true;
+  uint64_t windowUs = (200000ull << (regs[BK4819_REG_32] >> 14));
+  if (HOST_NowUs() - fcStartUs < windowUs)
+    return false;
+
+  uint32_t nowMs = HOST_NowUs() / 1000;
+  const SimTx *best = NULL;
+  for (uint8_t i = 0; i < gSimScene.txCount; ++i) {
+    const SimTx *tx = &gSimScene.tx[i];
+    if (tx->dbm < BK4819SIM_FC_MIN_DBM || !txActive(tx, nowMs))
+      continue;
+    if (!best || tx->dbm > best->dbm)
+      best = tx;
+  }
+  if (best) {
+    fcResult = best->f + jitter(BK4819SIM_FC_ERR);
+  } else {
+    rng = rng * 1103515245u + 12345u;
+    fcResult = 1800000 + (rng >> 8) % 100000000; // 18..1018 МГц
+  }
+  fcLatched = true;
+  return true;
+}
+
+static uint16_t rssiReg(int16_t dbm) {
+  int32_t v = (dbm + 160) * 2;
+  return v < 0 ? 0 : (v > 0x1FF ? 0x1FF : v);
+}
+
+// Чем сильнее сигнал над полом, тем ниже шум и глитчи
+static uint8_t noiseReg(int16_t dbm) {
+  int32_t snr = dbm - gSimScene.floorDbm;
+  int32_t v = 70 - snr * 2 + jitter(3);
+  return v < 2 ? 2 : (v > 127 ? 127 : v);
+}
+
+static uint8_t glitchReg(int16_t dbm) {
+  int32_t snr = dbm - gSimScene.floorDbm;
+  int32_t v = 60 - snr * 3 + jitter(4);
+  return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+void BK4819SIM_Reset(void) {
+  memset(regs, 0, sizeof(regs));
+  memset(&gSimStats, 0, sizeof(gSimStats));
+  tunedAtUs = 0;
+  settleUs = BK4819SIM_SETTLE_US;
+  lockFromF = 0;
+  rng = 1;
+  fcStartUs = 0;
+  fcLatched = false;
+}
+
+static void chargeRead(uint32_t us) {
+  HOST_Advance(us);
+  gSimStats.reads++;
+  gSimStats.busUs += us;
+}
+
+static uint16_t readValue(uint8_t reg) {
+  reg &= 0x7F;
+  switch (reg) {
+  case BK4819_REG_67:
+    return rssiReg(measuredDbm());
+  case BK4819_REG_65:
+    return noiseReg(measuredDbm());
+  case BK4819_REG_63:
+    return glitchReg(measuredDbm());
+  case 0x61: {
+    int32_t snr = measuredDbm() - gSimScene.floorDbm;
+    return 24 + (snr < 0 ? 0 : snr * 3);
+  }
+  case BK4819_REG_0D:
+    if (!fcResultReady())
+      return 0x8000;
+    return (fcResult >> 16) & 0x7FF;
+  case BK4819_REG_0E:
+    return fcResultReady() ? fcResult & 0xFFFF : 0;
+  case BK4819_REG_0C: {
+    int16_t dbm = measuredDbm();
+    bool open = vcoOn() && rssiReg(dbm) >= (regs[BK4819_REG_78] >> 8) &&
+                noiseReg(dbm) <= (regs[BK4819_REG_4F] & 0x7F);
+    return open << 1;
+  }
+  default:
+    return regs[reg];
+  }
+}
+
+uint16_t BK4819SIM_Read(uint8_t reg) {
+  chargeRead(BK4819SIM_READ_US);
+  return readValue(reg);
+}
+
+void BK4819SIM_ReadBurst(const uint8_t *regs, uint16_t *out, uint8_t n) {
+  for (uint8_t i = 0; i < n; ++i) {
+    chargeRead(i ? BK4819SIM_BURST_READ_US : BK4819SIM_READ_US);
+    out[i] = readValue(regs[i]);
+  }
+}
+
+void BK4819SIM_Write(uint8_t reg, uint16_t data) {
+  HOST_Advance(BK4819SIM_WRITE_US);
+  gSimStats.writes++;
+  gSimStats.busUs += BK4819SIM_WRITE_US;
+
+  reg &= 0x7F;
+  bool wasOn = vcoOn();
+  uint32_t prevF = tunedF();
+  uint16_t prev = regs[reg];
+  regs[reg] = data;
+
+  if (reg == BK4819_REG_32 && (data & 1)) {
+    fcStartUs = HOST_NowUs();
+    fcLatched = false;
+  }
+
+  if (((reg == BK4819_REG_38 || reg == BK4819_REG_39) && data != prev) ||
+      (reg == BK4819_REG_30 && vcoOn() && (!wasOn || data != prev))) {
+    // 38/39 пишутся по очереди: скачок считаем от частоты, где PLL
+    // стоял до начала серии записей, а не от промежуточной
+    uint64_t now = HOST_NowUs();
+    if (now - tunedAtUs >= settleUs)
+      lockFromF = prevF;
+    uint32_t f = tunedF();
+    settleUs = settleTime(f > lockFromF ? f - lockFromF : lockFromF - f);
+    tunedAtUs = now;
+    gSimStats.tunes++;
+  }
+}
+
+uint32_t BK4819SIM_GetFrequency(void) { return tunedF(); }
+
+// Формат сцены (строка = команда, # = комментарий):
+//   floor <dBm>
+//   tx <MHz> <dBm> [on_ms off_ms]
+//   band <start MHz> <end MHz> <step kHz>
+//   expect_cps <n>
+bool BK4819SIM_LoadScene(const char *path) {
+  FILE *fp = fopen(path, "r");
+  if (!fp) {
+    fprintf(stderr, "scene: cannot open %s\n", path);
+    return false;
+  }
+
+  memset(&gSimScene, 0, sizeof(gSimScene));
+  gSimScene.floorDbm = -125;
+
+  char line[256];
+  while (fgets(line, sizeof(line), fp)) {
+    char *p = line;
+    while (*p == ' ' || *p == '\t')
+      p++;
+    if (*p == '#' || *p == '\n' || *p == '\0')
+      continue;
+
+    int dbm, on = 0, off = 0;
+    double mhz, mhzEnd, khz;
+    if (sscanf(p, "floor %d", &dbm) == 1) {
+      gSimScene.floorDbm = dbm;
+    } else if (sscanf(p, "tx %lf %d %d %d", &mhz, &dbm, &on, &off) >= 2 ||
+               sscanf(p, "spur %lf %d", &mhz, &dbm) == 2) {
+      if (gSimScene.txCount >= BK4819SIM_MAX_TX)
+        continue;
+      SimTx *tx = &gSimScene.tx[gSimScene.txCount++];
+      tx->f = (uint32_t)(mhz * 100000.0 + 0.5);
+      tx->dbm = dbm;
+      tx->onMs = on;
+      tx->offMs = off;
+      tx->spur = *p == 's';
+    } else if (sscanf(p, "band %lf %lf %lf", &mhz, &mhzEnd, &khz) == 3) {
+      gSimScene.bandStart = (uint32_t)(mhz * 100000.0 + 0.5);
+      gSimScene.bandEnd = (uint32_t)(mhzEnd * 100000.0 + 0.5);
+      gSimScene.step = (uint16_t)(khz * 100.0 + 0.5);
+    } else if (sscanf(p, "expect_cps %d", &on) == 1) {
+      gSimScene.expectCps = on;
+    } else if (sscanf(p, "seconds %d", &on) == 1) {
+      gSimScene.seconds = on;
+    } else {
+      fprintf(stderr, "scene: bad line: %s", p);
+    }
+  }
+  fclose(fp);
+  return true;
+}
@@ -0,0 +1,65 @@
+#ifndef HOST_BK4819_SIM_H
+#define HOST_BK4819_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Модель BK4819 для хост-сборки: регистровый файл + RF-сцена.
+// Вместо bit-bang шины bk4829.c вызывает BK4819SIM_Read/BK4819SIM_Write,
+// каждая транзакция стоит виртуального времени как на железе.
+
+#define BK4819SIM_READ_US 55  // ~59 SHORT_DELAY по 40 NOP
+#define BK4819SIM_WRITE_US 70 // ~76 SHORT_DELAY по 40 NOP
+#define BK4819SIM_BURST_READ_US 54 // следующий регистр пачки: без паузы на CS
+#define BK4819SIM_SETTLE_US 1500 // PLL lock после скачка на 10+ МГц
+#define BK4819SIM_SETTLE_MIN_US 250 // перестройка в пределах канала
+#define BK4819SIM_VCO_OFF_DB 10     // насколько ниже пола RSSI с выключенным VCO
+#define BK4819SIM_FC_MIN_DBM -95    // слабее частотомер (REG_32) не ловит
+#define BK4819SIM_FC_ERR 30         // ошибка отсчёта частотомера, ±10 Hz
+
+#define BK4819SIM_MAX_TX 64
+
+typedef struct {
+  uint32_t f;       // 10 Hz
+  int16_t dbm;      // уровень на входе
+  uint16_t onMs;    // 0 = несущая всегда
+  uint16_t offMs;
+  bool spur;        // собственная помеха приёмника: ловить не надо
+} SimTx;
+
+typedef struct {
+  int16_t floorDbm;
+  uint8_t txCount;
+  SimTx tx[BK4819SIM_MAX_TX];
+
+  // Что сканировать и чего ждать (для scan_bench)
+  uint32_t bandStart;
+  uint32_t bandEnd;
+  uint16_t step;     // 10 Hz
+  uint16_t expectCps; // 0 = не проверять
+  uint16_t seconds;   // длина прогона по умолчанию, 0 — как у бенча
+} SimScene;
+
+typedef struct {
+  uint32_t reads;
+  uint32_t writes;
+  uint32_t busUs;        // суммарное время на шине
+  uint32_t tunes;        // перестроек PLL
+  uint32_t unsettled;    // замеров RSSI до захвата PLL
+} SimStats;
+
+extern SimScene gSimScene;
+extern SimStats gSimStats;
+
+void BK4819SIM_Reset(void);
+bool BK4819SIM_LoadScene(const char *path);
+
+uint16_t BK4819SIM_Read(uint8_t reg);
+// Пачка чтений в одной критической секции (BK4819_ReadMeasurementBurst)
+void BK4819SIM_ReadBurst(const uint8_t *regs, uint16_t *out, uint8_t n);
+void BK4819SIM_Write(uint8_t reg, uint16_t data);
+
+// Частота, на которую сейчас настроен синтезатор (без freqCorrection)
+uint32_t BK4819SIM_GetFrequency(void);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef HOST_PRINTF_H
+#define HOST_PRINTF_H
+
+// Хост-сборка: вместо embedded printf — libc, отладочный вывод прошивки
+// уходит в stderr и только при HOST_LOG=1 (см. host/stubs.c)
+#include <stdarg.h>
+#include <stdio.h>
+
+int HOST_Printf(const char *format, ...);
+#define printf HOST_Printf
+
+#endif
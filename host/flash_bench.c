@@ -0,0 +1,230 @@
+// Хост-бенчмарк флеша: реальные Storage_* / lfs.c / littlefs против
+// эмулятора PY25Q16 (py25q16_emu.c). Для каждой операции печатает байты по
+// SPI, число стираний и сколько миллисекунд она держит главный цикл.
+//
+//   make host-flash HOST_IMAGE=bin/flash.img
+//
+// С образом состояние ФС сохраняется между запусками — можно гонять
+// нагрузку на "изношенной" файловой системе.
+
+#include "../src/driver/lfs.h"
+#include "../src/driver/py25q16.h"
+#include "../src/helper/lootlist.h"
+#include "../src/helper/persist.h"
+#include "../src/helper/storage.h"
+#include "../src/inc/channel.h"
+#include "../src/radio.h"
+#include "../src/settings.h"
+#include "host.h"
+#include "py25q16_emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHANNELS_COUNT 500
+
+static RadioState radioState;
+
+typedef struct {
+  const char *name;
+  uint32_t calls;
+  uint32_t maxStallUs;
+  PY25Q16EmuStats before;
+} Op;
+
+static void opBegin(Op *op, const char *name) {
+  op->name = name;
+  op->calls = 0;
+  op->maxStallUs = 0;
+  op->before = gFlashStats;
+}
+
+static uint64_t callStart;
+
+static void callBegin(void) { callStart = HOST_NowUs(); }
+
+static void callEnd(Op *op) {
+  uint32_t us = HOST_NowUs() - callStart;
+  if (us > op->maxStallUs)
+    op->maxStallUs = us;
+  op->calls++;
+}
+
+static void opEnd(Op *op) {
+  PY25Q16EmuStats d = PY25Q16EMU_Diff(&op->before, &gFlashStats);
+  uint32_t busy = PY25Q16EMU_BusyUs(&d);
+  printf("%-16s %5u %8u %8u %6u %9u.%01u %8u.%01u %5u\n", op->name, op->calls,
+         d.bytesRead, d.bytesProgrammed, d.erases, busy / 1000,
+         busy / 100 % 10, op->maxStallUs / 1000, op->maxStallUs / 100 % 10,
+         d.norViolations);
+}
+
+static void benchSettings(void) {
+  Op op;
+  opBegin(&op, "SETTINGS_Save");
+  for (uint8_t i = 0; i < 10; ++i) {
+    gSettings.contrast = i;
+    callBegin();
+    SETTINGS_Save();
+    callEnd(&op);
+  }
+  opEnd(&op);
+
+  // переключения с клавиатуры: пачка правок — одна запись через PERSIST
+  opBegin(&op, "Settings toggles");
+  // нечётное число — итог отличается от записанного
+  for (uint8_t i = 0; i < 9; ++i) {
+    gSettings.alwaysRssi = !gSettings.alwaysRssi;
+    callBegin();
+    SETTINGS_DelayedSave();
+    PERSIST_Update();
+    callEnd(&op);
+    HOST_Advance(200 * 1000);
+  }
+  HOST_Advance(2000 * 1000);
+  callBegin();
+  PERSIST_Update();
+  callEnd(&op);
+  opEnd(&op);
+}
+
+static void benchChannels(void) {
+  Op op;
+  opBegin(&op, "Channels init");
+  callBegin();
+  STORAGE_INIT("Channels.ch", CH, CHANNELS_COUNT);
+  callEnd(&op);
+  opEnd(&op);
+
+  opBegin(&op, "Channel save");
+  for (uint16_t i = 0; i < 20; ++i) {
+    CH ch = {
+        .name = "CH",
+        .rxF = 14500000 + i * 2500,
+        .scanlists = 1,
+    };
+    callBegin();
+    STORAGE_SAVE("Channels.ch", (i * 37) % CHANNELS_COUNT, &ch);
+    callEnd(&op);
+  }
+  opEnd(&op);
+
+  opBegin(&op, "Channel load");
+  for (uint16_t i = 0; i < 20; ++i) {
+    CH ch;
+    callBegin();
+    STORAGE_LOAD("Channels.ch", (i * 37) % CHANNELS_COUNT, &ch);
+    callEnd(&op);
+  }
+  opEnd(&op);
+}
+
+static void benchLoot(void) {
+  LOOT_Clear();
+  for (uint8_t i = 0; i < LOOT_SIZE_MAX; ++i)
+    LOOT_Add(43300000 + i * 2500);
+
+  Op op;
+  opBegin(&op, "LOOT_Save");
+  for (uint8_t i = 0; i < 3; ++i) {
+    callBegin();
+    LOOT_Save();
+    callEnd(&op);
+  }
+  opEnd(&op);
+}
+
+// Как приложение Files: листинг корня при каждом заходе
+static void benchDirWalk(void) {
+  Op op;
+  opBegin(&op, "Dir walk");
+  for (uint8_t i = 0; i < 5; ++i) {
+    lfs_dir_t dir;
+    struct lfs_info info;
+    callBegin();
+    if (lfs_dir_open(&gLfs, &dir, "/") == 0) {
+      while (lfs_dir_read(&gLfs, &dir, &info) == 1)
+        ;
+      lfs_dir_close(&gLfs, &dir);
+    }
+    callEnd(&op);
+  }
+  opEnd(&op);
+}
+
+// Приёмник не меряет — драйвер берёт DIV2 вместо DIV8
+static bool alwaysQuiet(void) { return true; }
+
+static void benchQuiet(void) {
+  PY25Q16_SetQuietFn(alwaysQuiet);
+  Op op;
+  opBegin(&op, "Ch load, quiet");
+  for (uint16_t i = 0; i < 20; ++i) {
+    CH ch;
+    callBegin();
+    STORAGE_LOAD("Channels.ch", (i * 53 + 11) % CHANNELS_COUNT, &ch);
+    callEnd(&op);
+  }
+  opEnd(&op);
+
+  opBegin(&op, "LOOT_Save, quiet");
+  for (uint8_t i = 0; i < 3; ++i) {
+    callBegin();
+    LOOT_Save();
+    callEnd(&op);
+  }
+  opEnd(&op);
+  PY25Q16_SetQuietFn(NULL);
+}
+
+static void benchVfos(void) {
+  Op op;
+  opBegin(&op, "RADIO_SaveVFOs");
+  for (uint8_t i = 0; i < 3; ++i) {
+    callBegin();
+    RADIO_SaveAllVFOs(gRadioState);
+    callEnd(&op);
+  }
+  opEnd(&op);
+}
+
+int main(int argc, char **argv) {
+  const char *image = argc > 1 ? argv[1] : NULL;
+  if (!PY25Q16EMU_Open(image))
+    return 2;
+
+  printf("%-16s %5s %8s %8s %6s %11s %10s %5s\n", "op", "calls", "read B",
+         "prog B", "erase", "flash ms", "stall ms", "nor!");
+
+  Op op;
+  opBegin(&op, "mount");
+  callBegin();
+  fs_init();
+  callEnd(&op);
+  opEnd(&op);
+
+  gRadioState = &radioState;
+  RADIO_InitState(gRadioState, MAX_VFOS);
+  opBegin(&op, "RADIO_LoadVFOs");
+  callBegin();
+  RADIO_LoadVFOs(gRadioState);
+  callEnd(&op);
+  opEnd(&op);
+
+  benchSettings();
+  benchChannels();
+  benchLoot();
+  benchVfos();
+  benchDirWalk();
+  benchQuiet();
+
+  printf("total: %u erases, %u B programmed, %u ms flash busy\n",
+         gFlashStats.erases, gFlashStats.bytesProgrammed,
+         PY25Q16EMU_BusyUs(&gFlashStats) / 1000);
+  printf("prog: %u into erased, %u checked, %u erased by check\n",
+         gStorage.prog_fast, gStorage.prog_checked, gStorage.prog_erased);
+  printf("read: %u calls, %u pages cached, %u from flash\n",
+         gStorage.read_count, gStorage.read_hits, gStorage.read_misses);
+
+  PY25Q16EMU_Close();
+  return gFlashStats.norViolations ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+#ifndef HOST_HOST_H
+#define HOST_HOST_H
+
+#include <stdint.h>
+
+// Виртуальные часы хост-сборки. Now(), SYSTICK_Delay*, HRTIME_* идут от них,
+// поэтому замеры CPS воспроизводимы и не зависят от скорости ПК.
+
+uint64_t HOST_NowUs(void);
+void HOST_Advance(uint32_t us);
+
+// __WFI() в SYS_Main: ждём следующего тика SysTick (1 мс) или раньше —
+// компаратора HRTIME_ScheduleAt
+void HOST_WaitForInterrupt(void);
+
+#endif
@@ -0,0 +1,203 @@
+#include "py25q16_emu.h"
+#include "../src/driver/flash_sync.h"
+#include "../src/driver/py25q16.h"
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+PY25Q16EmuStats gFlashStats;
+bool gEepromWrite;
+
+static uint8_t image[PY25Q16EMU_SIZE];
+static FILE *imageFile;
+static bool opened;
+static uint64_t lastOpUs;
+static PY25Q16_QuietFn quietFn;
+static bool fastClock;
+
+// Как SPI_SelectClock в py25q16.c: скорость на каждую операцию
+static void selectClock(bool write) {
+  fastClock = quietFn && quietFn();
+  if (fastClock) {
+    gFlashStats.fastOps++;
+    return;
+  }
+  gFlashStats.slowOps++;
+  if (write)
+    gFlashStats.slowWrites++;
+}
+
+static void chargeSpi(uint32_t bytes) {
+  uint32_t ns = fastClock ? PY25Q16EMU_SPI_FAST_NS_PER_BYTE
+                          : PY25Q16EMU_SPI_NS_PER_BYTE;
+  // команда + 3 байта адреса (+ dummy для fast read)
+  uint32_t us = ((bytes + 5) * ns + 999) / 1000;
+  gFlashStats.spiUs += us;
+  HOST_Advance(us);
+}
+
+static void throttle(uint32_t gapMs) {
+  uint64_t now = HOST_NowUs();
+  uint64_t gapUs = (uint64_t)gapMs * 1000;
+  if (now - lastOpUs < gapUs) {
+    uint32_t us = gapUs - (now - lastOpUs);
+    gFlashStats.throttleUs += us;
+    HOST_Advance(us);
+  }
+}
+
+static void flushRange(uint32_t addr, uint32_t size) {
+  if (!imageFile)
+    return;
+  fseek(imageFile, addr, SEEK_SET);
+  fwrite(image + addr, 1, size, imageFile);
+  fflush(imageFile);
+}
+
+bool PY25Q16EMU_Open(const char *path) {
+  PY25Q16EMU_Close();
+  memset(image, 0xFF, sizeof(image));
+  opened = true;
+
+  if (!path)
+    return true;
+
+  imageFile = fopen(path, "r+b");
+  if (imageFile) {
+    size_t n = fread(image, 1, sizeof(image), imageFile);
+    if (n < sizeof(image))
+      flushRange(n, sizeof(image) - n);
+    return true;
+  }
+
+  // нового образа нет — создаём стёртый
+  imageFile = fopen(path, "w+b");
+  if (!imageFile) {
+    fprintf(stderr, "flash: cannot open %s\n", path);
+    return false;
+  }
+  flushRange(0, sizeof(image));
+  return true;
+}
+
+void PY25Q16EMU_Close(void) {
+  if (imageFile) {
+    fclose(imageFile);
+    imageFile = NULL;
+  }
+  opened = false;
+}
+
+void PY25Q16EMU_ResetStats(void) {
+  memset(&gFlashStats, 0, sizeof(gFlashStats));
+}
+
+uint32_t PY25Q16EMU_BusyUs(const PY25Q16EmuStats *s) {
+  return s->spiUs + s->progUs + s->eraseUs + s->throttleUs;
+}
+
+PY25Q16EmuStats PY25Q16EMU_Diff(const PY25Q16EmuStats *a,
+                                const PY25Q16EmuStats *b) {
+  PY25Q16EmuStats d;
+  const uint32_t *pa = (const uint32_t *)a;
+  const uint32_t *pb = (const uint32_t *)b;
+  uint32_t *pd = (uint32_t *)&d;
+  for (size_t i = 0; i < sizeof(d) / sizeof(uint32_t); ++i)
+    pd[i] = pb[i] - pa[i];
+  return d;
+}
+
+// ============================================================================
+// Драйвер (заменяет src/driver/py25q16.c)
+// ============================================================================
+
+void PY25Q16_Init() {
+  if (!opened)
+    PY25Q16EMU_Open(NULL);
+}
+
+void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size) {
+  if (Address >= PY25Q16EMU_SIZE)
+    return;
+  if (Size > PY25Q16EMU_SIZE - Address)
+    Size = PY25Q16EMU_SIZE - Address;
+
+  selectClock(false);
+  memcpy(pBuffer, image + Address, Size);
+  gFlashStats.readOps++;
+  gFlashStats.bytesRead += Size;
+  chargeSpi(Size);
+}
+
+void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
+                         bool Append) {
+  flash_lock();
+  throttle(PY25Q16EMU_WRITE_GAP_MS);
+  selectClock(true);
+  gFlashStats.progOps++;
+
+  const uint8_t *src = pBuffer;
+  uint32_t written = 0;
+  while (written < Size && Address + written < PY25Q16EMU_SIZE) {
+    uint32_t addr = Address + written;
+    uint32_t chunk = PY25Q16EMU_PAGE - addr % PY25Q16EMU_PAGE;
+    if (chunk > Size - written)
+      chunk = Size - written;
+
+    for (uint32_t i = 0; i < chunk; ++i) {
+      uint8_t cur = image[addr + i];
+      uint8_t v = src[written + i];
+      if (v & ~cur)
+        gFlashStats.norViolations++;
+      image[addr + i] = cur & v; // NOR: только 1→0
+    }
+    flushRange(addr, chunk);
+
+    gFlashStats.pagePrograms++;
+    gFlashStats.bytesProgrammed += chunk;
+    chargeSpi(chunk);
+    gFlashStats.progUs += PY25Q16EMU_PAGE_PROG_US;
+    HOST_Advance(PY25Q16EMU_PAGE_PROG_US);
+
+    written += chunk;
+  }
+
+  lastOpUs = HOST_NowUs();
+  flash_unlock();
+}
+
+void PY25Q16_SectorErase(uint32_t Address) {
+  flash_lock();
+  Address &= ~(PY25Q16EMU_SECTOR - 1);
+  if (Address >= PY25Q16EMU_SIZE) {
+    flash_unlock();
+    return;
+  }
+
+  throttle(PY25Q16EMU_ERASE_GAP_MS);
+  selectClock(true);
+
+  memset(image + Address, 0xFF, PY25Q16EMU_SECTOR);
+  flushRange(Address, PY25Q16EMU_SECTOR);
+
+  gFlashStats.erases++;
+  chargeSpi(0);
+  gFlashStats.eraseUs += PY25Q16EMU_SECTOR_ERASE_US;
+  HOST_Advance(PY25Q16EMU_SECTOR_ERASE_US);
+
+  lastOpUs = HOST_NowUs();
+  flash_unlock();
+}
+
+void PY25Q16_SetQuietFn(PY25Q16_QuietFn fn) { quietFn = fn; }
+
+void PY25Q16_FullErase() {
+  memset(image, 0xFF, sizeof(image));
+  flushRange(0, sizeof(image));
+}
+
+static bool locked;
+
+void flash_lock(void) { locked = true; }
+void flash_unlock(void) { locked = false; }
+bool flash_is_locked(void) { return locked; }
@@ -0,0 +1,53 @@
+#ifndef HOST_PY25Q16_EMU_H
+#define HOST_PY25Q16_EMU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Эмулятор PY25Q16 для хост-сборки: образ 2 МБ в файле, NOR-семантика
+// (программирование только 1→0, стирание сектором 4 КБ). Время операций
+// идёт в виртуальные часы, включая паузы драйвера между операциями.
+
+#define PY25Q16EMU_SIZE (2u * 1024 * 1024)
+#define PY25Q16EMU_SECTOR 4096
+#define PY25Q16EMU_PAGE 256
+
+// SPI2 на DIV8 = 6 МГц: ~1.33 мкс на байт; DIV2 (приёмник не меряет) — 24 МГц
+#define PY25Q16EMU_SPI_NS_PER_BYTE 1333
+#define PY25Q16EMU_SPI_FAST_NS_PER_BYTE 333
+#define PY25Q16EMU_PAGE_PROG_US 700  // tPP typ
+#define PY25Q16EMU_SECTOR_ERASE_US 45000 // tSE typ
+#define PY25Q16EMU_WRITE_GAP_MS 20   // как в py25q16.c
+#define PY25Q16EMU_ERASE_GAP_MS 100
+
+typedef struct {
+  uint32_t readOps;
+  uint32_t bytesRead;
+  uint32_t progOps;
+  uint32_t pagePrograms;
+  uint32_t bytesProgrammed;
+  uint32_t erases;
+  uint32_t spiUs;      // пересылка по шине
+  uint32_t progUs;     // ожидание WIP после page program
+  uint32_t eraseUs;    // ожидание WIP после sector erase
+  uint32_t throttleUs; // паузы драйвера между операциями
+  uint32_t norViolations; // попытки записать 1 поверх 0 без стирания
+  uint32_t fastOps; // операций на DIV2
+  uint32_t slowOps; // на DIV8: проверки тишины нет или сканер меряет
+  uint32_t slowWrites; // из них программирований и стираний
+} PY25Q16EmuStats;
+
+extern PY25Q16EmuStats gFlashStats;
+
+// path == NULL — образ только в памяти
+bool PY25Q16EMU_Open(const char *path);
+void PY25Q16EMU_Close(void);
+void PY25Q16EMU_ResetStats(void);
+
+// Суммарное время флеш-операций, мкс
+uint32_t PY25Q16EMU_BusyUs(const PY25Q16EmuStats *s);
+// Разница двух снимков статистики
+PY25Q16EmuStats PY25Q16EMU_Diff(const PY25Q16EmuStats *a,
+                                const PY25Q16EmuStats *b);
+
+#endif
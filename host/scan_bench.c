@@ -0,0 +1,447 @@
+// Хост-бенчмарк сканера: scan.c + radio.c + lootlist.c + spectrum.c против
+// модели BK4819 (bk4819_sim.c) и RF-сцены.
+//
+//   make host-bench HOST_SCENE=host/scenes/vhf.scene HOST_SECONDS=10
+//   (+ HOST_CAL=1 — откалибровать warmup, HOST_ALGO=0..3 — детектор,
+//    HOST_COARSE=1 — двухпроходный скан, HOST_HW=1 — поиск частотомером,
+//    HOST_CH=1 — скан по каналам: передатчики сцены пишутся в Channels.ch,
+//    HOST_PRIO=<f> — приоритетная частота (10 Hz) посреди прохода;
+//    trace=<файл> — трасса шины BK4819 для host/trace_replay;
+//    save=<ms> — правка настроек с клавиатуры каждые ms, запись через PERSIST)
+//
+// Главный цикл повторяет SYS_Main: PERSIST_Update(), SCAN_Check() и __WFI()
+// до тика SysTick
+// или до прерывания TIM2, которым сканер отмечает конец warmup.
+// Код возврата != 0, если CPS ниже expect_cps или передатчик не найден.
+
+#include "../src/driver/bk4829.h"
+#include "../src/driver/lfs.h"
+#include "../src/driver/systick.h"
+#include "../src/helper/bktrace.h"
+#include "../src/helper/lootlist.h"
+#include "../src/helper/measurements.h"
+#include "../src/helper/persist.h"
+#include "../src/helper/scan.h"
+#include "../src/helper/storage.h"
+#include "../src/inc/channel.h"
+#include "../src/radio.h"
+#include "../src/settings.h"
+#include "bk4819_sim.h"
+#include "host.h"
+#include "py25q16_emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static RadioState radioState;
+
+static Step stepFromScene(uint16_t step) {
+  for (uint8_t i = 0; i < STEP_COUNT; ++i) {
+    if (StepFrequencyTable[i] == step)
+      return i;
+  }
+  fprintf(stderr, "scene: unsupported step %u, using 25 kHz\n", step);
+  return STEP_25_0kHz;
+}
+
+static void setupRadio(void) {
+  PY25Q16_Init();
+  PY25Q16_SetQuietFn(SCAN_IsRfQuiet);
+  fs_init();
+
+  BK4819_Init();
+
+  gRadioState = &radioState;
+  RADIO_InitState(gRadioState, MAX_VFOS);
+  RADIO_LoadVFOs(gRadioState);
+}
+
+// Как SCANER_init, только диапазон берём из сцены
+static void setupScan(void) {
+  // по умолчанию на несущей висим вечно — бенчмарку нужно идти дальше
+  gSettings.sqOpenedTimeout = SCAN_TO_250ms;
+  gSettings.sqClosedTimeout = SCAN_TO_250ms;
+
+  gCurrentBand = (Band){
+      .name = "Bench",
+      .start = gSimScene.bandStart,
+      .end = gSimScene.bandEnd,
+      .step = stepFromScene(gSimScene.step),
+      .bw = BK4819_FILTER_BW_12k,
+      .squelch.value = 4,
+  };
+
+  SCAN_SetDelay(1800);
+  SCAN_SetMode(SCAN_MODE_FREQUENCY);
+  SCAN_Init();
+}
+
+// Стоимость применения настроек: все параметры поверх уже применённых
+// (как переключение VFO/мультивотч на похожий канал) и смена диапазона
+static void benchApplyStep(const char *name) {
+  static SimStats before;
+  static uint32_t saved0;
+  if (!name) {
+    before = gSimStats;
+    saved0 = BK4819_GetBatchSaved();
+    return;
+  }
+  printf("%-10s %u writes (%u batched away), %u reads, %u us\n", name,
+         gSimStats.writes - before.writes, BK4819_GetBatchSaved() - saved0,
+         gSimStats.reads - before.reads, gSimStats.busUs - before.busUs);
+}
+
+static void benchApply(void) {
+  benchApplyStep(NULL);
+  ctx->dirty = PARAM_ALL;
+  RADIO_ApplySettings(ctx);
+  benchApplyStep("apply all:");
+
+  benchApplyStep(NULL);
+  SCAN_SetBand(gCurrentBand);
+  benchApplyStep("set band:");
+}
+
+static bool hwHunt;
+
+// Частотомер видит только сильнейшую несущую: остальные в hw не требуем
+static const char *hwSkipReason(const SimTx *tx) {
+  if (tx->dbm < BK4819SIM_FC_MIN_DBM)
+    return "below counter";
+  for (uint8_t i = 0; i < gSimScene.txCount; ++i) {
+    if (gSimScene.tx[i].dbm > tx->dbm)
+      return "masked";
+  }
+  return NULL;
+}
+
+#define BENCH_CHANNELS 500 // как на радио: Channels.ch на все каналы
+#define BENCH_CH_FILLER 40 // каналов не из сцены, половина — в другом листе
+
+// Каналы в скан-листе 1: передатчики сцены (модуляция и полоса у
+// соседних разные — скан применяет их на каждом шаге) и пустые частоты
+// диапазона; часть — в листе 2, их скан пропускать должен
+static void writeChannels(void) {
+  uint16_t step = StepFrequencyTable[gCurrentBand.step];
+  uint32_t span = gSimScene.bandEnd - gSimScene.bandStart;
+  uint16_t n = 0;
+
+  Storage_Init("Channels.ch", sizeof(CH), BENCH_CHANNELS);
+  for (uint8_t i = 0; i < gSimScene.txCount; ++i) {
+    const SimTx *tx = &gSimScene.tx[i];
+    CH ch = {
+        .name = "TX",
+        .rxF = RoundToStep(tx->f, step),
+        .scanlists = 1,
+        .modulation = i % 2 ? MOD_AM : MOD_FM,
+        .bw = i % 2 ? BK4819_FILTER_BW_20k : BK4819_FILTER_BW_12k,
+        .radio = RADIO_BK4819,
+        .squelch.value = 4,
+    };
+    STORAGE_SAVE("Channels.ch", n++ * 3, &ch);
+  }
+  for (uint8_t i = 0; i < BENCH_CH_FILLER; ++i) {
+    CH ch = {
+        .name = "FILL",
+        .rxF = RoundToStep(gSimScene.bandStart + span / BENCH_CH_FILLER * i +
+                               span / BENCH_CH_FILLER / 2,
+                           step),
+        .scanlists = i % 2 ? 1 : 2,
+        .modulation = MOD_FM,
+        .bw = BK4819_FILTER_BW_12k,
+        .radio = RADIO_BK4819,
+        .squelch.value = 4,
+    };
+    STORAGE_SAVE("Channels.ch", n++ * 3 + 1, &ch);
+  }
+}
+
+static void setupChannels(void) {
+  writeChannels();
+  gSettings.currentScanlist = 1;
+  uint32_t t0 = HOST_NowUs();
+  SCAN_SetMode(SCAN_MODE_CHANNEL);
+  uint32_t us = HOST_NowUs() - t0;
+  printf("channels: %u of %u in scanlist, loaded in %u.%03u ms\n",
+         SCAN_GetChannelCount(), SCAN_GetChannelListed(), us / 1000,
+         us % 1000);
+}
+
+// Правки настроек посреди скана: сколько ждали записи и не попала ли
+// запись на медленную шину (сканер в это время мерил). Чтения на медленной
+// допустимы — их сканер ждать не может
+typedef struct {
+  uint32_t everyMs;
+  uint32_t nextAt;
+  uint32_t toggles;
+  uint32_t saves;
+  uint32_t markedAt; // первая правка, ещё не записанная
+  uint32_t maxWaitMs;
+  PY25Q16EmuStats before;
+} SaveLoad;
+
+static SaveLoad saveLoad;
+
+static void saveLoadStep(uint32_t now) {
+  SaveLoad *s = &saveLoad;
+  if (!s->everyMs)
+    return;
+  if (s->markedAt && !PERSIST_Pending()) {
+    if (now - s->markedAt > s->maxWaitMs)
+      s->maxWaitMs = now - s->markedAt;
+    s->markedAt = 0;
+    s->saves++;
+  }
+  if ((int32_t)(now - s->nextAt) < 0)
+    return;
+  s->nextAt = now + s->everyMs;
+  gSettings.alwaysRssi = !gSettings.alwaysRssi;
+  SETTINGS_DelayedSave();
+  s->toggles++;
+  if (!s->markedAt)
+    s->markedAt = now;
+}
+
+// false — запись шла на медленной шине
+static bool saveLoadReport(void) {
+  const SaveLoad *s = &saveLoad;
+  if (!s->everyMs)
+    return true;
+  PY25Q16EmuStats d = PY25Q16EMU_Diff(&s->before, &gFlashStats);
+  printf("persist: %u toggles, %u saves, max wait %u ms\n", s->toggles,
+         s->saves, s->maxWaitMs);
+  printf("flash: %u ops fast, %u slow (%u writes)\n", d.fastOps, d.slowOps,
+         d.slowWrites);
+  if (d.slowWrites) {
+    printf("FAIL: flash written while the scanner was measuring\n");
+    return false;
+  }
+  return true;
+}
+
+static void traceSink(const char *line, void *ctx) { fputs(line, ctx); }
+
+// Последние BK4819_TRACE_SIZE транзакций — хвост прогона
+static void saveTrace(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    fprintf(stderr, "trace: cannot open %s\n", path);
+    return;
+  }
+  BKTRACE_Write(traceSink, f);
+  fclose(f);
+  printf("trace: %u records -> %s\n", BK4819_TraceCount(), path);
+}
+
+// Прерывистые передатчики: сколько передач поймано (loot открылся, пока
+// передача шла) и через сколько после её начала
+typedef struct {
+  uint32_t bursts;
+  uint32_t caught;
+  uint32_t latencySum;
+  uint32_t lastBurst; // номер передачи, которая уже засчитана
+} BurstStat;
+
+static BurstStat burstStat[BK4819SIM_MAX_TX];
+
+static void trackBursts(uint32_t startMs, uint32_t nowMs) {
+  uint16_t step = StepFrequencyTable[gCurrentBand.step];
+  for (uint8_t i = 0; i < gSimScene.txCount; ++i) {
+    const SimTx *tx = &gSimScene.tx[i];
+    if (!tx->onMs)
+      continue;
+    uint32_t period = tx->onMs + tx->offMs;
+    uint32_t n = nowMs / period + 1; // с 1: 0 — ещё ни одной
+    uint32_t phase = nowMs % period;
+    BurstStat *b = &burstStat[i];
+    if (phase >= tx->onMs || b->lastBurst == n || nowMs - phase < startMs)
+      continue;
+    Loot *l = LOOT_Get(RoundToStep(tx->f, step));
+    if (l && l->open && SCAN_GetState() == SCAN_STATE_LISTENING &&
+        RADIO_GetParam(ctx, PARAM_FREQUENCY) == l->f) {
+      b->lastBurst = n;
+      b->caught++;
+      b->latencySum += phase;
+    }
+  }
+}
+
+static void reportBursts(uint32_t startMs, uint32_t endMs) {
+  for (uint8_t i = 0; i < gSimScene.txCount; ++i) {
+    const SimTx *tx = &gSimScene.tx[i];
+    if (!tx->onMs)
+      continue;
+    uint32_t period = tx->onMs + tx->offMs;
+    // передачи, начавшиеся за прогон
+    uint32_t bursts = (endMs - 1) / period - (startMs + period - 1) / period + 1;
+    const BurstStat *b = &burstStat[i];
+    printf("  burst %4u.%05u: caught %u/%u, %u ms after start\n",
+           tx->f / MHZ, tx->f % MHZ, b->caught, bursts,
+           b->caught ? b->latencySum / b->caught : 0);
+  }
+}
+
+static bool checkLoot(void) {
+  bool ok = true;
+  uint16_t step = StepFrequencyTable[gCurrentBand.step];
+
+  printf("loot: %u\n", LOOT_Size());
+  for (uint8_t i = 0; i < gSimScene.txCount; ++i) {
+    const SimTx *tx = &gSimScene.tx[i];
+    if (tx->f < gSimScene.bandStart || tx->f > gSimScene.bandEnd)
+      continue;
+    bool found = LOOT_Get(RoundToStep(tx->f, step)) != NULL;
+    const char *skip = tx->spur ? "spur"
+                       : hwHunt  ? hwSkipReason(tx)
+                                 : NULL;
+    printf("  tx %4u.%05u %4d dBm: %s\n", tx->f / MHZ, tx->f % MHZ, tx->dbm,
+           found ? "found" : skip ? skip : "MISSED");
+    ok &= found || skip;
+  }
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <scene> [seconds] [cal] [coarse] [hw] [ch] "
+            "[prio=F] [algo=N] [save=ms] [trace=file]\n",
+            argv[0]);
+    return 2;
+  }
+  // 0 или без аргумента — длина из сцены (seconds), иначе 10 с
+  uint32_t seconds = argc > 2 ? atoi(argv[2]) : 0;
+  bool calibrate = false, coarse = false, channels = false;
+  unsigned prioF = 0, saveMs = 0;
+  int algo = SCAN_ALGO_ADAPTIVE;
+  const char *tracePath = NULL;
+  for (int i = 3; i < argc; ++i) {
+    if (!strcmp(argv[i], "cal"))
+      calibrate = true;
+    else if (!strcmp(argv[i], "coarse"))
+      coarse = true;
+    else if (!strcmp(argv[i], "hw"))
+      hwHunt = true;
+    else if (!strcmp(argv[i], "ch"))
+      channels = true;
+    else if (sscanf(argv[i], "prio=%u", &prioF) == 1)
+      SCAN_AddPriority(prioF);
+    else if (sscanf(argv[i], "save=%u", &saveMs) == 1)
+      saveLoad.everyMs = saveMs;
+    else if (!strncmp(argv[i], "trace=", 6))
+      tracePath = argv[i] + 6;
+    else if (sscanf(argv[i], "algo=%d", &algo) != 1)
+      fprintf(stderr, "unknown option: %s\n", argv[i]);
+  }
+
+  setupRadio();
+  if (!BK4819SIM_LoadScene(argv[1]))
+    return 2;
+  if (!gSimScene.bandEnd) {
+    fprintf(stderr, "scene: no band\n");
+    return 2;
+  }
+  if (!seconds)
+    seconds = gSimScene.seconds ? gSimScene.seconds : 10;
+  setupScan();
+  benchApply();
+  SCAN_SetAlgo(algo);
+  if (coarse)
+    SCAN_SetCoarse(true);
+  if (hwHunt)
+    SCAN_SetHwHunt(true);
+  if (channels)
+    setupChannels();
+  if (calibrate) {
+    // калибровка — не сканирование, в CPS и загрузку шины не входит
+    if (!SCAN_CalibrateDelay())
+      fprintf(stderr, "warmup: calibration failed\n");
+  }
+
+  uint32_t cpsSum = 0, cpsN = 0;
+  uint32_t lastSec = Now() / 1000;
+  uint32_t endMs = Now() + seconds * 1000;
+  SimStats start = gSimStats;
+  uint32_t shadow0 = BK4819_GetShadowHits();
+  uint32_t sweeps0 = SCAN_GetSweeps();
+  uint32_t checks = 0; // кандидатов детектора — каждый стоит checkDelayMs
+  ScanState prevState = SCAN_GetState();
+  uint32_t startMs = Now();
+  uint32_t firstLootMs = 0; // сколько ждали первую находку
+  uint32_t prioVisits = 0, prioAt = startMs, prioGapMs = 0;
+  bool wasPrio = false;
+  saveLoad.nextAt = startMs + saveMs;
+  saveLoad.before = gFlashStats;
+
+  while (Now() < endMs) {
+    saveLoadStep(Now());
+    PERSIST_Update();
+    SCAN_Check();
+    ScanState st = SCAN_GetState();
+    if (st == SCAN_STATE_CHECKING && prevState != st)
+      checks++;
+    prevState = st;
+    if (!firstLootMs && LOOT_Size())
+      firstLootMs = Now() - startMs;
+    if (SCAN_IsPriorityVisit() && !wasPrio) {
+      // интервал между заходами на приоритетную — от начала до начала
+      if (Now() - prioAt > prioGapMs)
+        prioGapMs = Now() - prioAt;
+      prioAt = Now();
+      prioVisits++;
+    }
+    wasPrio = SCAN_IsPriorityVisit();
+    trackBursts(startMs, Now());
+    if (!SCAN_IsSampleDue())
+      HOST_WaitForInterrupt();
+
+    uint32_t sec = Now() / 1000;
+    if (sec != lastSec) {
+      lastSec = sec;
+      // первую секунду CPS ещё не посчитан
+      if (SCAN_GetCps()) {
+        cpsSum += SCAN_GetCps();
+        cpsN++;
+      }
+    }
+  }
+
+  uint32_t cps = cpsN ? cpsSum / cpsN : 0;
+  uint32_t reads = gSimStats.reads - start.reads;
+  uint32_t writes = gSimStats.writes - start.writes;
+  uint32_t busMs = (gSimStats.busUs - start.busUs) / 1000;
+
+  printf("scene: %s, %u s\n", argv[1], seconds);
+  printf("warmup: %u us%s\n", SCAN_GetDelay(),
+         SCAN_IsAutoDelay() ? " (calibrated)" : "");
+  printf("algo: %s, %u checks\n", SCAN_ALGO_NAMES[SCAN_GetAlgo()], checks);
+  printf("cps: %u\n", cps);
+  uint32_t sweeps = SCAN_GetSweeps() - sweeps0;
+  printf("sweeps: %u (%u ms per cycle)\n", sweeps,
+         sweeps ? seconds * 1000 / sweeps : 0);
+  if (firstLootMs)
+    printf("first loot: %u ms\n", firstLootMs);
+  printf("bus: %u reads, %u writes, %u ms (%u%%)\n", reads, writes, busMs,
+         busMs * 100 / (seconds * 1000));
+  printf("shadow: %u reads saved\n", BK4819_GetShadowHits() - shadow0);
+  if (prioF)
+    printf("prio: %u visits, max gap %u ms\n", prioVisits, prioGapMs);
+  printf("pll: %u tunes, %u unsettled reads\n", gSimStats.tunes - start.tunes,
+         gSimStats.unsettled - start.unsettled);
+
+  if (tracePath)
+    saveTrace(tracePath);
+  reportBursts(startMs, endMs);
+
+  bool ok = checkLoot();
+  ok = saveLoadReport() && ok;
+  // двухпроходный скан и частотомер нарочно делают меньше замеров: CPS
+  // падает, а цикл по диапазону короче — порог CPS к ним не применим.
+  // Каналы перестраиваются скачками, приоритетная отнимает замеры — тоже
+  if (!coarse && !hwHunt && !channels && !prioF && gSimScene.expectCps &&
+      cps < gSimScene.expectCps) {
+    printf("FAIL: cps %u < expected %u\n", cps, gSimScene.expectCps);
+    ok = false;
+  }
+  printf("%s\n", ok ? "OK" : "FAIL");
+  return ok ? 0 : 1;
+}
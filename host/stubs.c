@@ -0,0 +1,206 @@
+// Заглушки периферии для хост-сборки: всё, что в прошивке трогает железо,
+// но не влияет на поведение сканера.
+
+#include "../src/apps/apps.h"
+#include "../src/board.h"
+#include "../src/driver/audio.h"
+#include "../src/driver/backlight.h"
+#include "../src/driver/battery.h"
+#include "../src/driver/bk1080.h"
+#include "../src/driver/hrtime.h"
+#include "../src/driver/si473x.h"
+#include "../src/driver/st7565.h"
+#include "../src/driver/systick.h"
+#include "../src/driver/uart.h"
+#include "../src/helper/fsk2.h"
+#include "host.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Виртуальное время
+// ============================================================================
+
+static uint64_t nowUs;
+
+// Одноразовый компаратор TIM2 CC1 (HRTIME_ScheduleAt)
+static HRTIME_Callback hrCb;
+static uint64_t hrDeadlineUs;
+
+static void fireHrtime(void) {
+  if (hrCb && nowUs >= hrDeadlineUs) {
+    HRTIME_Callback cb = hrCb;
+    hrCb = NULL;
+    cb();
+  }
+}
+
+uint64_t HOST_NowUs(void) { return nowUs; }
+
+void HOST_Advance(uint32_t us) {
+  nowUs += us;
+  fireHrtime();
+}
+
+void HOST_WaitForInterrupt(void) {
+  uint64_t wake = (nowUs / 1000 + 1) * 1000;
+  if (hrCb && hrDeadlineUs < wake)
+    wake = hrDeadlineUs > nowUs ? hrDeadlineUs : nowUs;
+  nowUs = wake;
+  fireHrtime();
+}
+
+uint32_t Now() { return nowUs / 1000; }
+void SYSTICK_Init(void) {}
+void SYSTICK_DelayTicks(const uint32_t ticks) { HOST_Advance(ticks / 48); }
+void SYSTICK_DelayUs(uint32_t Delay) { HOST_Advance(Delay); }
+void SYSTICK_DelayMs(uint32_t Delay) { HOST_Advance(Delay * 1000); }
+
+void SetTimeout(uint32_t *v, uint32_t t) {
+  *v = t == UINT32_MAX ? UINT32_MAX : Now() + t;
+}
+
+bool CheckTimeout(uint32_t *v) {
+  if (*v == UINT32_MAX) {
+    return false;
+  }
+  return (int32_t)(Now() - *v) >= 0;
+}
+
+void HRTIME_Init(void) {}
+uint32_t HRTIME_Now(void) { return (uint32_t)(nowUs * 48u); }
+void HRTIME_DelayUs(uint32_t us) { HOST_Advance(us); }
+
+void HRTIME_ScheduleAt(uint32_t deadline, HRTIME_Callback cb) {
+  int32_t ticks = (int32_t)(deadline - HRTIME_Now());
+  hrDeadlineUs = nowUs + (ticks > 0 ? (ticks + 47) / 48 : 0);
+  hrCb = cb;
+  fireHrtime();
+}
+
+void HRTIME_Cancel(void) { hrCb = NULL; }
+
+// ============================================================================
+// UART / лог (HOST_LOG=1 — печатать)
+// ============================================================================
+
+static int logEnabled = -1;
+
+static bool LogOn(void) {
+  if (logEnabled < 0) {
+    const char *e = getenv("HOST_LOG");
+    logEnabled = e && *e == '1';
+  }
+  return logEnabled;
+}
+
+void Log(const char *pattern, ...) {
+  if (!LogOn())
+    return;
+  va_list args;
+  va_start(args, pattern);
+  fprintf(stderr, "[%8u] ", Now());
+  vfprintf(stderr, pattern, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+void LogC(LogColor c, const char *pattern, ...) {
+  if (!LogOn())
+    return;
+  va_list args;
+  va_start(args, pattern);
+  fprintf(stderr, "[%8u] \033[%um", Now(), c);
+  vfprintf(stderr, pattern, args);
+  fputs("\033[0m\n", stderr);
+  va_end(args);
+}
+
+int HOST_Printf(const char *format, ...) {
+  if (!LogOn())
+    return 0;
+  va_list args;
+  va_start(args, format);
+  int n = vfprintf(stderr, format, args);
+  va_end(args);
+  return n;
+}
+
+void LogUart(const char *const str) {
+  if (LogOn())
+    fputs(str, stderr);
+}
+
+void UART_Send(const void *pBuffer, uint32_t Size) {
+  if (LogOn())
+    fwrite(pBuffer, 1, Size, stderr);
+}
+
+// ============================================================================
+// Дисплей, подсветка, плата, батарея
+// ============================================================================
+
+uint8_t gFrameBuffer[FRAME_LINES][LCD_WIDTH];
+bool gLineChanged[FRAME_LINES];
+bool gRedrawScreen = true;
+bool gSuppressDisplayUpdates;
+
+void ST7565_SetContrast(uint8_t contrast) {}
+void ST7565_Blit(void) {}
+
+void BACKLIGHT_SetBrightness(uint8_t brigtness) {}
+void BACKLIGHT_TurnOff() {}
+void BACKLIGHT_TurnOn() {}
+
+void BOARD_ToggleGreen(bool on) {}
+void BOARD_ToggleRed(bool on) {}
+
+void AUDIO_ToggleSpeaker(bool on) {}
+
+uint16_t gBatteryVoltage = 800;
+uint16_t gBatteryCurrent;
+uint8_t gBatteryPercent = 100;
+bool gChargingWithTypeC;
+const char *const BATTERY_TYPE_NAMES[4] = {"1600mAh", "2200mAh", "3500mAh", "USB"};
+const char *const BATTERY_STYLE_NAMES[3] = {"Plain", "Percent", "Voltage"};
+
+uint32_t BATTERY_GetPreciseVoltage(uint16_t cal) { return 8000; }
+
+// ============================================================================
+// Приложения
+// ============================================================================
+
+// Имя нужно RADIO_LoadVFOs для каталога VFO, остальное не вызывается
+const App apps[APPS_COUNT] = {
+    [APP_SCANER] = {.name = "Scanner", .needsRadioState = true},
+};
+const AppType_t appsAvailableToRun[RUN_APPS_COUNT] = {APP_SCANER};
+AppType_t gCurrentApp = APP_SCANER;
+
+// ============================================================================
+// Второстепенные приёмники и FSK
+// ============================================================================
+
+void BK1080_Init(uint32_t f, bool bEnable) {}
+void BK1080_Mute(bool Mute) {}
+void BK1080_SetFrequency(uint32_t frequency) {}
+uint16_t BK1080_ReadRegister(BK1080_Register_t Register) { return 0; }
+uint16_t BK1080_GetRSSI() { return 0; }
+uint8_t BK1080_GetSNR() { return 0; }
+
+RSQStatus rsqStatus;
+void RSQ_GET() {}
+void SI47XX_PowerUp() {}
+void SI47XX_PatchPowerUp() {}
+void SI47XX_PowerDown() {}
+void SI47XX_SwitchMode(SI47XX_MODE mode) {}
+void SI47XX_SetAutomaticGainControl(uint8_t AGCDIS, uint8_t AGCIDX) {}
+void SI47XX_SetBandwidth(SI47XX_FilterBW AMCHFLT, bool AMPLFLT) {}
+void SI47XX_SetSsbBandwidth(SI47XX_SsbFilterBW bw) {}
+void SI47XX_SetVolume(uint8_t volume) {}
+void SI47XX_TuneTo(uint32_t f) {}
+
+void RF_EnterFsk(void) {}
+void RF_ExitFsk(void) {}
@@ -0,0 +1,227 @@
+// Разбор трассы шины BK4819 (helper/bktrace.c): транзакции прогоняются через
+// модель bk4819_sim.c в исходном темпе, время шины раскладывается по
+// регистрам и по местам вызова функций шины драйвера.
+//
+//   bin/trace_replay <trace> [elf]
+//
+// Трасса — с радио (UART или файл Bus.bkt с LFS) или из scan_bench trace=.
+// С elf адреса вызовов переводятся в функции через addr2line; для прошивки
+// это bin/<проект>, для хоста — тот же бинарник, что писал трассу.
+// Место — непосредственный вызывающий Read/WriteRegister и т.п.: регистры,
+// читаемые через помощники драйвера, попадают на сам помощник.
+
+// popen/pclose
+#define _DEFAULT_SOURCE
+
+#include "../src/driver/bk4829.h"
+#include "bk4819_sim.h"
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SITES 1024
+#define TOP_SITES 16
+
+typedef struct {
+  uint32_t reads;
+  uint32_t writes;
+  uint32_t same; // запись того же значения, что уже в регистре
+  uint32_t us;
+} RegStat;
+
+typedef struct {
+  uint32_t pc;
+  uint32_t calls; // транзакций с этого места
+  uint32_t us;
+} SiteStat;
+
+static BK4819_TraceRec recs[4096];
+static uint32_t recCount;
+static uint32_t ticksPerMs;
+
+static RegStat regStat[128];
+static SiteStat sites[MAX_SITES];
+static uint16_t siteCount;
+static uint32_t otherSitesUs; // не влезли в MAX_SITES
+
+static bool load(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "trace: cannot open %s\n", path);
+    return false;
+  }
+
+  char line[128];
+  unsigned long tpm = 0, count = 0, lost = 0;
+  while (fgets(line, sizeof(line), f)) {
+    // UART-выгрузка перемешана с логом: берём только свои строки
+    char *p = strstr(line, "BKT");
+    if (!p)
+      continue;
+    if (sscanf(p, "BKT0 %lx %lx %lx", &tpm, &count, &lost) == 3) {
+      ticksPerMs = tpm;
+      recCount = 0;
+      continue;
+    }
+    unsigned long t, pc;
+    unsigned flags, reg, value;
+    if (sscanf(p, "BKT %lx %lx %x %x %x", &t, &pc, &flags, &reg, &value) != 5)
+      continue;
+    if (recCount >= sizeof(recs) / sizeof(recs[0]))
+      break;
+    recs[recCount++] = (BK4819_TraceRec){
+        .t = t, .pc = pc, .flags = flags, .reg = reg & 0x7F, .value = value};
+  }
+  fclose(f);
+
+  if (!ticksPerMs || !recCount) {
+    fprintf(stderr, "trace: no records in %s\n", path);
+    return false;
+  }
+  if (lost)
+    printf("trace: %lu older records lost (ring overflow)\n", lost);
+  return true;
+}
+
+static SiteStat *site(uint32_t pc) {
+  for (uint16_t i = 0; i < siteCount; ++i) {
+    if (sites[i].pc == pc)
+      return &sites[i];
+  }
+  if (siteCount == MAX_SITES)
+    return NULL;
+  sites[siteCount].pc = pc;
+  return &sites[siteCount++];
+}
+
+static void account(const BK4819_TraceRec *r, uint32_t us) {
+  RegStat *rs = &regStat[r->reg];
+  rs->us += us;
+  SiteStat *s = site(r->pc);
+  if (s) {
+    s->calls++;
+    s->us += us;
+  } else {
+    otherSitesUs += us;
+  }
+}
+
+// Прогон через модель: время транзакции — сколько она заняла на модели
+static void replay(void) {
+  static uint16_t last[128];
+  static bool known[128];
+  uint32_t tpu = ticksPerMs / 1000;
+  uint32_t t0 = recs[0].t;
+  uint64_t base = HOST_NowUs();
+
+  BK4819SIM_Reset();
+  for (uint32_t i = 0; i < recCount; ++i) {
+    const BK4819_TraceRec *r = &recs[i];
+    // паузы между транзакциями — как в трассе (счётчик 32 бит, по модулю)
+    uint64_t at = base + (uint32_t)(r->t - t0) / tpu;
+    if (HOST_NowUs() < at)
+      HOST_Advance(at - HOST_NowUs());
+
+    if (r->flags & BK4819_TRACE_WRITE) {
+      uint32_t busUs = gSimStats.busUs;
+      regStat[r->reg].writes++;
+      if (known[r->reg] && last[r->reg] == r->value)
+        regStat[r->reg].same++;
+      BK4819SIM_Write(r->reg, r->value);
+      known[r->reg] = true;
+      last[r->reg] = r->value;
+      account(r, gSimStats.busUs - busUs);
+      continue;
+    }
+
+    // чтение вместе с продолжениями пачки (CS не отпускался)
+    uint8_t regs[8];
+    uint16_t out[8];
+    uint8_t n = 0;
+    do {
+      regs[n] = recs[i + n].reg;
+      n++;
+    } while (n < 8 && i + n < recCount &&
+             (recs[i + n].flags & BK4819_TRACE_BURST));
+    BK4819SIM_ReadBurst(regs, out, n);
+    for (uint8_t k = 0; k < n; ++k) {
+      regStat[regs[k]].reads++;
+      account(&recs[i + k],
+              k ? BK4819SIM_BURST_READ_US : BK4819SIM_READ_US);
+    }
+    i += n - 1;
+  }
+}
+
+static void symbol(const char *elf, uint32_t pc, char *out, size_t size) {
+  snprintf(out, size, "?");
+  if (!elf)
+    return;
+  char cmd[512];
+  // адрес возврата указывает за вызов — берём байт до него
+  snprintf(cmd, sizeof(cmd), "addr2line -f -s -e '%s' 0x%x", elf, pc - 1);
+  FILE *p = popen(cmd, "r");
+  if (!p)
+    return;
+  char fn[128] = "?", loc[128] = "";
+  if (fgets(fn, sizeof(fn), p) && fgets(loc, sizeof(loc), p)) {
+    fn[strcspn(fn, "\n")] = 0;
+    loc[strcspn(loc, "\n")] = 0;
+    snprintf(out, size, "%s (%s)", fn, loc);
+  }
+  pclose(p);
+}
+
+static int bySiteUs(const void *a, const void *b) {
+  const SiteStat *sa = a, *sb = b;
+  return sa->us < sb->us ? 1 : sa->us > sb->us ? -1 : 0;
+}
+
+static void report(const char *elf) {
+  uint32_t tpu = ticksPerMs / 1000;
+  uint32_t spanUs = (recs[recCount - 1].t - recs[0].t) / tpu;
+  uint32_t busUs = 0;
+  for (uint8_t r = 0; r < 128; ++r)
+    busUs += regStat[r].us;
+
+  printf("records: %u over %u.%03u ms, bus %u us (%u%%)\n", recCount,
+         spanUs / 1000, spanUs % 1000, busUs,
+         spanUs ? (uint32_t)((uint64_t)busUs * 100 / spanUs) : 100);
+  printf("pll: %u tunes, %u unsettled reads\n", gSimStats.tunes,
+         gSimStats.unsettled);
+
+  printf("\n%-4s %7s %7s %7s %9s %5s\n", "reg", "reads", "writes", "same",
+         "bus us", "%");
+  for (uint8_t r = 0; r < 128; ++r) {
+    const RegStat *rs = &regStat[r];
+    if (!rs->reads && !rs->writes)
+      continue;
+    printf("0x%02X %7u %7u %7u %9u %5u\n", r, rs->reads, rs->writes, rs->same,
+           rs->us, busUs ? rs->us * 100 / busUs : 0);
+  }
+
+  qsort(sites, siteCount, sizeof(sites[0]), bySiteUs);
+  printf("\n%-10s %7s %9s %5s  %s\n", "site", "xfers", "bus us", "%",
+         "function");
+  for (uint8_t i = 0; i < siteCount && i < TOP_SITES; ++i) {
+    char name[256];
+    symbol(elf, sites[i].pc, name, sizeof(name));
+    printf("0x%08x %7u %9u %5u  %s\n", sites[i].pc, sites[i].calls,
+           sites[i].us, busUs ? sites[i].us * 100 / busUs : 0, name);
+  }
+  if (otherSitesUs)
+    printf("(other sites: %u us)\n", otherSitesUs);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <trace> [elf]\n", argv[0]);
+    return 2;
+  }
+  if (!load(argv[1]))
+    return 2;
+  replay();
+  report(argc > 2 ? argv[2] : NULL);
+  return 0;
+}
@@ -5,6 +5,7 @@
 #include "../helper/bands.h"
 #include "../helper/lootlist.h"
 #include "../helper/measurements.h"
+#include "../helper/persist.h"
 #include "../helper/regs-menu.h"
 #include "../helper/scan.h"
 #include "../helper/storage.h"
@@ -19,37 +20,30 @@
 
 // ── Analyser state ─────────────────────────────────────────────────────────
 
+#define ANALYSER_SAVE_DELAY_MS 1000
+
 typedef struct {
   int16_t dbMin;
   int16_t dbMax;
 } AnalyserSettings;
 
 static AnalyserSettings aSettings = {.dbMin = -120, .dbMax = -20};
-static uint32_t analyserSaveTime;
 
 static void analyserSettingsLoad(void) {
   STORAGE_LOAD("analyser.set", 0, &aSettings);
 }
 
 static void analyserSettingsSave(void) {
-  STORAGE_SAVE("analyser.set", 0, &aSettings);
+  STORAGE_SAVE_CHANGED("analyser.set", 0, &aSettings);
 }
 
 void ANALYSER_UpdateSave(void) {
-  if (ANALYSERMENU_IsDirty()) {
-    if (analyserSaveTime == 0) {
-      analyserSaveTime = Now() + 1000;
-    } else if (Now() > analyserSaveTime) {
-      // Sync values and save
-      aSettings.dbMin = ANALYSERMENU_GetDbmMin();
-      aSettings.dbMax = ANALYSERMENU_GetDbmMax();
-      analyserSettingsSave();
-      ANALYSERMENU_ClearDirty();
-      analyserSaveTime = 0;
-    }
-  } else {
-    analyserSaveTime = 0;
-  }
+  if (!ANALYSERMENU_IsDirty())
+    return;
+  aSettings.dbMin = ANALYSERMENU_GetDbmMin();
+  aSettings.dbMax = ANALYSERMENU_GetDbmMax();
+  ANALYSERMENU_ClearDirty();
+  PERSIST_Mark(analyserSettingsSave, ANALYSER_SAVE_DELAY_MS);
 }
 
 // ── Analyser state ─────────────────────────────────────────────────────────
@@ -476,7 +470,7 @@ void ANALYSER_deinit(void) {
   // Sync back from analysermenu and save
   aSettings.dbMin = ANALYSERMENU_GetDbmMin();
   aSettings.dbMax = ANALYSERMENU_GetDbmMax();
-  analyserSettingsSave();
+  PERSIST_Mark(analyserSettingsSave, 0); // запишет APPS_deinit
 }
 
 // -------------------------------------------------------------------------
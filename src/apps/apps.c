@@ -4,6 +4,7 @@
 #include "../driver/uart.h"
 #include "../helper/keymap.h"
 #include "../helper/menu.h"
+#include "../helper/persist.h"
 #include "../settings.h"
 #include "../ui/chlist.h"
 #include "../ui/graphics.h"
@@ -130,6 +131,8 @@ void APPS_deinit(void) {
   if (apps[gCurrentApp].deinit) {
     apps[gCurrentApp].deinit();
   }
+  // отложенное пишем до смены приложения: раскладка привязана к нему
+  PERSIST_Flush();
 }
 
 RadioState radioState;
@@ -7,6 +7,7 @@
 #include "../helper/menu.h"
 #include "../helper/scan.h"
 #include "../helper/scancommand.h"
+#include "../helper/storage.h"
 #include "../ui/components.h"
 #include "../ui/finput.h"
 #include "../ui/graphics.h"
@@ -74,6 +75,7 @@ static void LoadFile(const char *filename) {
   struct lfs_file_config config = {.buffer = buffer, .attr_count = 0};
   lfs_file_t file;
 
+  Storage_Close(filename);
   int err = lfs_file_opencfg(&gLfs, &file, filename, LFS_O_RDONLY, &config);
   if (err < 0) {
     Log("[CMDEDIT] Open failed: %d (%s)", err, filename);
@@ -136,6 +138,7 @@ static void SaveFile(void) {
   struct lfs_file_config cfg = {.buffer = filebuf, .attr_count = 0};
   lfs_file_t file;
 
+  Storage_Close(gEditCtx.filename);
   int err = lfs_file_opencfg(&gLfs, &file, gEditCtx.filename,
                              LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, &cfg);
   Log("[CMDEDIT] lfs_open(W): %d, file=%s", err, gEditCtx.filename);
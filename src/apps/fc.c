@@ -26,7 +26,7 @@
 static const uint8_t REQUIRED_FREQUENCY_HITS = 2;
 static const uint8_t FILTER_SWITCH_INTERVAL = REQUIRED_FREQUENCY_HITS;
 
-static const char *FILTER_NAMES[] = {
+static const char *const FILTER_NAMES[] = {
     [FILTER_OFF] = "ALL",
     [FILTER_VHF] = "Very HF",
     [FILTER_UHF] = "Ultra HF",
@@ -179,7 +179,6 @@ void FC_update(void) {
     return;
 
   RADIO_UpdateMultiwatch(gRadioState);
-  RADIO_CheckAndSaveVFO(gRadioState);
 
   // Отложенный перезапуск сканера (неблокирующий)
   if (pendingScanRestart) {
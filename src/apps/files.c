@@ -3,6 +3,7 @@
 #include "../driver/uart.h"
 #include "../helper/menu.h"
 #include "../helper/screenshot.h"
+#include "../helper/storage.h"
 #include "../ui/components.h"
 #include "../ui/graphics.h"
 #include "../ui/statusline.h"
@@ -87,6 +88,8 @@ static void deleteItem(const char *name, FileType type) {
     snprintf(fullPath, sizeof(fullPath), "%s/%s", gCurrentPath, name);
   }
 
+  // файл может держать открытым кеш Storage — закрываем до удаления
+  Storage_Flush();
   int err = lfs_remove(&gLfs, fullPath);
   if (err < 0) {
     char msg[32];
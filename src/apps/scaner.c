@@ -58,6 +58,22 @@ static void initBand(void) {
   }
 }
 
+// С мультивотчем остальные VFO не теряются и во время скана: их частоты
+// сканер навещает между шагами (SCAN_AddPriority)
+static void initPriority(void) {
+  SCAN_ClearPriority();
+  SCAN_SetPriorityInterval(SETTINGS_GetPrioIntervalMs());
+  if (!gSettings.mWatch)
+    return;
+  for (uint8_t i = 0; i < gRadioState->num_vfos; ++i) {
+    VFOContext *c = &gRadioState->vfos[i].context;
+    if (i == gRadioState->active_vfo_index || c->radio_type != RADIO_BK4819)
+      continue;
+    if (!SCAN_AddPriority(RADIO_GetParam(c, PARAM_FREQUENCY)))
+      break;
+  }
+}
+
 void SCANER_init(void) {
   SPECTRUM_Y = 16;
   SPECTRUM_H = LCD_HEIGHT - SPECTRUM_Y - 16 - 7;
@@ -73,7 +89,9 @@ void SCANER_init(void) {
   BANDS_RangePush(gCurrentBand);
 
   SCAN_SetDelay(1800);
+  SCAN_SetAutoDelay(true); // 1800 — пока шаг не откалиброван
 
+  initPriority();
   SCAN_SetMode(SCAN_MODE_FREQUENCY);
   SCAN_Init();
 }
@@ -119,6 +137,44 @@ static bool handleLongPress(KEY_Code_t key) {
     SCAN_SetBand(*BANDS_RangePeek());
     return true;
 
+  case KEY_4:
+    // пол диапазона мог уехать — снимем заново на следующем проходе
+    SCAN_ForgetFloor();
+    return true;
+
+  case KEY_5:
+    // поиск частотомером вместо перебора
+    SCAN_SetHwHunt(!SCAN_IsHwHunt());
+    gRedrawScreen = true;
+    return true;
+
+  case KEY_0:
+    // замер времени установления RSSI для текущего диапазона и шага
+    SCAN_CalibrateDelay();
+    gRedrawScreen = true;
+    return true;
+
+  case KEY_SIDE1:
+    // каналы текущего скан-листа <-> диапазон
+    if (SCAN_GetMode() == SCAN_MODE_CHANNEL) {
+      SCAN_SetMode(SCAN_MODE_FREQUENCY);
+    } else {
+      SCAN_SetMode(SCAN_MODE_CHANNEL);
+      if (!SCAN_GetChannelCount())
+        SCAN_SetMode(SCAN_MODE_FREQUENCY); // в скан-листе пусто
+    }
+    gRedrawScreen = true;
+    return true;
+
+  case KEY_SIDE2:
+    // последняя активная частота — в приоритетные и обратно
+    if (!gLastActiveLoot)
+      return false;
+    if (!SCAN_RemovePriority(gLastActiveLoot->f))
+      SCAN_AddPriority(gLastActiveLoot->f);
+    gRedrawScreen = true;
+    return true;
+
   case KEY_PTT:
     if (gSettings.keylock) {
       pttWasLongPressed = true;
@@ -196,6 +252,14 @@ static bool handleRelease(KEY_Code_t key) {
     SCAN_NextBlacklist();
     return true;
 
+  case KEY_4:
+    SCAN_SetAlgo((SCAN_GetAlgo() + 1) % SCAN_ALGO_COUNT);
+    return true;
+
+  case KEY_0:
+    SCAN_SetCoarse(!SCAN_IsCoarse());
+    return true;
+
   case KEY_SIDE2:
     SCAN_NextWhitelist();
     return true;
@@ -313,8 +377,21 @@ void SCANER_render(void) {
   STATUSLINE_RenderRadioSettings();
 
   // Строка 1 (y=14): задержка слева, имя диапазона по центру, шаг справа
-  PrintSmallEx(0, 12, POS_L, C_FILL, "%uus", SCAN_GetDelay());
-  PrintSmallEx(LCD_WIDTH, 12, POS_R, C_FILL, "%d.%02d", step / KHZ, step % KHZ);
+  PrintSmallEx(0, 12, POS_L, C_FILL, "%uus%s %s%s%s", SCAN_GetDelay(),
+               SCAN_IsAutoDelay() ? " A" : "", SCAN_ALGO_NAMES[SCAN_GetAlgo()],
+               SCAN_IsHwHunt() ? " HW" : SCAN_IsCoarse() ? " 2P" : "",
+               SCAN_IsPriorityVisit()   ? " PRI"
+               : SCAN_GetPriorityCount() ? " P"
+                                         : "");
+  if (SCAN_GetMode() == SCAN_MODE_CHANNEL) {
+    // "+" — в скан-листе больше каналов, чем сканер держит
+    PrintSmallEx(LCD_WIDTH, 12, POS_R, C_FILL, "CH%d/%u%s",
+                 SCAN_GetChannel() + 1, SCAN_GetChannelCount(),
+                 SCAN_GetChannelListed() > SCAN_GetChannelCount() ? "+" : "");
+  } else {
+    PrintSmallEx(LCD_WIDTH, 12, POS_R, C_FILL, "%d.%02d", step / KHZ,
+                 step % KHZ);
+  }
 
   ScanState state = SCAN_GetState();
 
@@ -329,8 +406,9 @@ void SCANER_render(void) {
       const uint32_t ago = (Now() - v->lastTimeOpen) / 1000;
       mhzToS(String, v->f);
 
-      PrintMediumEx(0, y, POS_L, C_FILL, "%s %02u:%02u", String, ago / 60,
-                    ago % 60);
+      // "*" — приоритетная (долгое SIDE2)
+      PrintMediumEx(0, y, POS_L, C_FILL, "%s%s %02u:%02u", String,
+                    SCAN_IsPriority(v->f) ? "*" : "", ago / 60, ago % 60);
 
       if (v->code != 255) {
         if (v->isCd) {
@@ -50,7 +50,7 @@ static void setUpConv(uint32_t v, uint32_t _) {
 static void setFcorr(uint32_t v, uint32_t _) {
   (void)_;
   SETTINGS_SetValue(SETTING_FREQ_CORRECTION, v);
-  ctx->dirty[PARAM_FREQUENCY] = true;
+  ctx->dirty |= PARAM_BIT(PARAM_FREQUENCY);
   RADIO_ApplySettings(ctx);
 }
 
@@ -111,6 +111,7 @@ static const MenuItem scanMenuItems[] = {
     {"Listen t/o", SETTING_SQOPENEDTIMEOUT, getValS, updateValS},
     {"Stay t", SETTING_SQCLOSEDTIMEOUT, getValS, updateValS},
     {"Skip X_X", SETTING_SKIPGARBAGEFREQUENCIES, getValS, updateValS},
+    {"Prio t", SETTING_PRIO_INTERVAL, getValS, updateValS},
 };
 
 static Menu scanMenu = {.title = "Scan",
@@ -119,7 +119,7 @@ static bool handleLongPress(KEY_Code_t key) {
   case KEY_2:
     if (gCurrentApp == APP_VFO1) {
       gSettings.iAmPro = !gSettings.iAmPro;
-      SETTINGS_Save();
+      SETTINGS_DelayedSave();
       return true;
     }
     return false;
@@ -4,12 +4,16 @@
 #include "../helper/measurements.h"
 #include "../settings.h"
 #include "bk4819-regs.h"
-#include "gpio.h"
-#include "py32f071_ll_spi.h"
+#include "hrtime.h"
 #include "systick.h"
 #include <stdint.h>
 
-static uint16_t reg30state = 0xffff;
+#ifdef HOST_BUILD
+#include "../../host/bk4819_sim.h"
+#else
+#include "gpio.h"
+#include "py32f071_ll_spi.h"
+#endif
 
 // 40 NOP вместо 25 — мягкие фронты bit-bang SPI, меньше RF помех
 #define SHORT_DELAY()                                                          \
@@ -37,9 +41,6 @@ static const uint16_t MOD_TYPE_REG47_VALUES[] = {
 
 static const uint8_t SQUELCH_TYPE_VALUES[4] = {0x88, 0xAA, 0xCC, 0xFF};
 
-static const uint8_t DTMF_COEFFS[] = {111, 107, 103, 98, 80,  71,  58,  44,
-                                      65,  55,  37,  23, 228, 203, 181, 159};
-
 const Gain GAIN_TABLE[32] = {
     {0x3ff, 0},  // AUTO
     {0x3ff, 0},  //
@@ -97,14 +98,11 @@ static ModulationType gLastModulation = 255;
 // ============================================================================
 // Low-Level GPIO and SPI Operations
 // ============================================================================
+#ifndef HOST_BUILD
 #define PIN_CSN GPIO_MAKE_PIN(GPIOF, LL_GPIO_PIN_9)
 #define PIN_SCL GPIO_MAKE_PIN(GPIOB, LL_GPIO_PIN_8)
 #define PIN_SDA GPIO_MAKE_PIN(GPIOB, LL_GPIO_PIN_9)
 
-// ============================================================================
-// Register Access
-// ============================================================================
-
 static inline void CS_Assert() { GPIO_ResetOutputPin(PIN_CSN); }
 
 static inline void CS_Release() { GPIO_SetOutputPin(PIN_CSN); }
@@ -126,10 +124,6 @@ static inline uint32_t SDA_ReadInput() {
   return GPIO_IsInputPinSet(PIN_SDA) ? 1 : 0;
 }
 
-static inline uint16_t scale_frequency(uint16_t freq) {
-  return (((uint32_t)freq * 1353245u) + (1u << 16)) >> 17; // with rounding
-}
-
 static uint16_t BK4819_ReadU16(void) {
   unsigned int i;
   uint16_t Value;
@@ -150,10 +144,7 @@ static uint16_t BK4819_ReadU16(void) {
   return Value;
 }
 
-uint16_t BK4819_ReadRegister(BK4819_REGISTER_t reg) {
-  if (reg == BK4819_REG_30 && reg30state != 0xffff) {
-    return reg30state;
-  }
+static uint16_t BusRead(BK4819_REGISTER_t reg) {
   __disable_irq();
   // printf("R R 0x%x\n", reg);
   uint16_t Value;
@@ -177,11 +168,32 @@ uint16_t BK4819_ReadRegister(BK4819_REGISTER_t reg) {
   return Value;
 }
 
-void BK4819_WriteRegister(BK4819_REGISTER_t reg, uint16_t Data) {
-  // printf("W R 0x%x\n", reg);
-  if (reg == BK4819_REG_30) {
-    reg30state = Data;
+// Несколько регистров подряд: одна критическая секция, между кадрами
+// только пауза на CS. Автоинкремента адреса у BK4819 нет — адрес на
+// каждый регистр
+static void BusReadBurst(const uint8_t *regs, uint16_t *out, uint8_t n) {
+  __disable_irq();
+  CS_Release();
+  SCL_Reset();
+
+  SHORT_DELAY();
+
+  for (uint8_t i = 0; i < n; ++i) {
+    CS_Assert();
+    BK4819_WriteU8(regs[i] | 0x80);
+    out[i] = BK4819_ReadU16();
+    CS_Release();
+
+    SHORT_DELAY();
   }
+
+  SCL_Set();
+  SDA_Set();
+  __enable_irq();
+}
+
+static void BusWrite(BK4819_REGISTER_t reg, uint16_t Data) {
+  // printf("W R 0x%x\n", reg);
   __disable_irq();
   CS_Release();
   SCL_Reset();
@@ -247,6 +259,259 @@ void BK4819_WriteU16(uint16_t Data) {
     SHORT_DELAY();
   }
 }
+#else
+// Хост-сборка: шина — модель чипа (host/bk4819_sim.c)
+#define BusRead(reg) BK4819SIM_Read(reg)
+#define BusWrite(reg, data) BK4819SIM_Write(reg, data)
+#define BusReadBurst(regs, out, n) BK4819SIM_ReadBurst(regs, out, n)
+#endif
+
+// ============================================================================
+// Register Access
+// ============================================================================
+
+static inline uint16_t scale_frequency(uint16_t freq) {
+  return (((uint32_t)freq * 1353245u) + (1u << 16)) >> 17; // with rounding
+}
+
+// Теневая копия регистров: конфигурацию меняем только мы, поэтому
+// чтение для read-modify-write берём из памяти, а не с шины (чтение —
+// ~60 SHORT_DELAY с запрещёнными прерываниями). Запись — сквозная.
+// Держим только то, что трогает скан на шаге и при смене канала: VCO,
+// PLL, фильтры, шумодав (0x30..0x4F) и модуляция/AFC (0x70..0x7F) —
+// 96 байт вместо 256, остальное — как раньше с шины
+#define SHADOW_NONE 0xFF
+#define SHADOW_COUNT 48
+static uint16_t shadow[SHADOW_COUNT];
+static uint64_t shadowValid; // бит на ячейку
+static uint32_t shadowHits; // чтений с шины не понадобилось
+
+// Регистры, которые меняет сам чип: статус, замеры, частотомер,
+// самосбрасывающиеся биты FSK, индекс AGC — всегда с шины
+static bool IsVolatileReg(uint8_t reg) {
+  switch (reg) {
+  case 0x02: // флаги прерываний
+  case 0x0B: // статус DTMF/CSS
+  case 0x0C: // шумодав, VOX
+  case 0x0D: // частотомер
+  case 0x0E:
+  case 0x59: // очистка FIFO FSK
+  case 0x5F: // FIFO FSK
+  case 0x7E: // текущий индекс AGC
+    return true;
+  default:
+    return reg >= 0x61 && reg <= 0x6F; // RSSI, шум, глитчи, CSS, AFC
+  }
+}
+
+static inline uint8_t ShadowIndex(uint8_t reg) {
+  if (reg >= 0x30 && reg < 0x50)
+    return reg - 0x30;
+  if (reg >= 0x70 && reg < 0x80)
+    return reg - 0x70 + 32;
+  return SHADOW_NONE;
+}
+
+static inline bool ShadowHas(uint8_t reg) {
+  uint8_t i = ShadowIndex(reg);
+  return i != SHADOW_NONE && (shadowValid & (1ull << i));
+}
+
+// Смысл — только после ShadowHas
+static inline uint16_t ShadowGet(uint8_t reg) {
+  uint8_t i = ShadowIndex(reg);
+  return i == SHADOW_NONE ? 0 : shadow[i];
+}
+
+static inline void ShadowStore(uint8_t reg, uint16_t value) {
+  uint8_t i = ShadowIndex(reg);
+  if (i == SHADOW_NONE || IsVolatileReg(reg))
+    return;
+  shadow[i] = value;
+  shadowValid |= 1ull << i;
+}
+
+// ============================================================================
+// Трассировка шины (-DBK4819_TRACE): кольцо последних транзакций для
+// разбора на ПК (helper/bktrace.c, host/trace_replay.c)
+// ============================================================================
+
+#ifdef BK4819_TRACE
+static BK4819_TraceRec traceRing[BK4819_TRACE_SIZE];
+static uint16_t traceHead;  // следующая запись
+static uint16_t traceCount;
+static uint32_t traceLost;  // затёрто по кругу
+static bool traceOn;
+static uint32_t traceSite;  // адрес возврата из функции шины
+
+// Сайт — непосредственный вызывающий Read/WriteRegister, EndBatch или
+// ReadMeasurementBurst. Для регистров, читаемых через помощники
+// (BK4819_GetRSSI, GetRegValue...), это сам помощник, а не его вызывающий:
+// return_address(1) на Thumb без frame pointer ненадёжен
+#define TRACE_SITE()                                                           \
+  (traceSite = (uint32_t)(uintptr_t)__builtin_return_address(0))
+
+static void TraceBus(uint8_t reg, uint16_t value, uint8_t flags) {
+  if (!traceOn)
+    return;
+  BK4819_TraceRec *r = &traceRing[traceHead];
+  r->t = HRTIME_Now();
+  r->pc = traceSite;
+  r->reg = reg & 0x7F;
+  r->flags = flags;
+  r->value = value;
+  traceHead = (traceHead + 1) % BK4819_TRACE_SIZE;
+  if (traceCount < BK4819_TRACE_SIZE)
+    traceCount++;
+  else
+    traceLost++;
+}
+
+void BK4819_TraceEnable(bool on) {
+  if (on) {
+    traceHead = 0;
+    traceCount = 0;
+    traceLost = 0;
+  }
+  traceOn = on;
+}
+
+uint16_t BK4819_TraceCount(void) { return traceCount; }
+uint32_t BK4819_TraceLost(void) { return traceLost; }
+
+const BK4819_TraceRec *BK4819_TraceGet(uint16_t i) {
+  if (i >= traceCount)
+    return NULL;
+  uint16_t first = (traceHead + BK4819_TRACE_SIZE - traceCount) %
+                   BK4819_TRACE_SIZE;
+  return &traceRing[(first + i) % BK4819_TRACE_SIZE];
+}
+#else
+#define TRACE_SITE() ((void)0)
+#define TraceBus(reg, value, flags) ((void)0)
+#endif
+
+static void ShadowInvalidate(void) { shadowValid = 0; }
+
+// Пакет записей (BK4819_BeginBatch/EndBatch): запись в регистр копится,
+// повторная в тот же регистр заменяет значение, совпадающая с тем, что
+// уже в чипе, отбрасывается. На шину — в порядке первой записи
+#define BATCH_MAX 24
+
+typedef struct {
+  uint8_t reg;
+  bool chipKnown; // chip — значение в чипе до пакета
+  uint16_t chip;
+  uint16_t value;
+} BatchEntry;
+
+static struct {
+  uint8_t depth;
+  uint8_t count;
+  BatchEntry e[BATCH_MAX];
+} batch;
+
+static uint32_t batchSaved; // записей на шину не понадобилось
+
+// Запись сама по себе действие (сброс, калибровка VCO, мультиплексный
+// регистр тонов, коэффициенты DTMF, FIFO, сброс флагов), а не значение:
+// не копим и не склеиваем, всё накопленное уходит до неё
+static bool IsOrderedReg(uint8_t reg) {
+  switch (reg) {
+  case BK4819_REG_00:
+  case BK4819_REG_02:
+  case BK4819_REG_07:
+  case BK4819_REG_09:
+  case BK4819_REG_30:
+  case BK4819_REG_32:
+  case BK4819_REG_59:
+  case BK4819_REG_5F:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static void BatchFlush(void) {
+  for (uint8_t i = 0; i < batch.count; ++i) {
+    const BatchEntry *e = &batch.e[i];
+    if (e->chipKnown && e->value == e->chip) {
+      batchSaved++; // вернули как было
+      continue;
+    }
+    BusWrite(e->reg, e->value);
+    TraceBus(e->reg, e->value, BK4819_TRACE_WRITE);
+  }
+  batch.count = 0;
+}
+
+static void BatchPut(uint8_t reg, uint16_t value) {
+  for (uint8_t i = 0; i < batch.count; ++i) {
+    if (batch.e[i].reg == reg) {
+      batch.e[i].value = value;
+      ShadowStore(reg, value);
+      batchSaved++;
+      return;
+    }
+  }
+  bool known = ShadowHas(reg);
+  if (known && ShadowGet(reg) == value) {
+    batchSaved++;
+    return;
+  }
+  if (batch.count == BATCH_MAX)
+    BatchFlush();
+  batch.e[batch.count++] = (BatchEntry){
+      .reg = reg,
+      .chipKnown = known,
+      .chip = ShadowGet(reg),
+      .value = value,
+  };
+  ShadowStore(reg, value); // RMW внутри пакета видит новое значение
+}
+
+void BK4819_BeginBatch(void) { batch.depth++; }
+
+void BK4819_EndBatch(void) {
+  TRACE_SITE();
+  if (batch.depth && --batch.depth == 0)
+    BatchFlush();
+}
+
+uint32_t BK4819_GetBatchSaved(void) { return batchSaved; }
+
+uint16_t BK4819_ReadRegister(BK4819_REGISTER_t reg) {
+  uint8_t r = reg & 0x7F;
+  if (ShadowHas(r)) {
+    shadowHits++;
+    return ShadowGet(r);
+  }
+  TRACE_SITE();
+  BatchFlush(); // с шины — после накопленных записей
+  uint16_t value = BusRead(reg);
+  TraceBus(r, value, 0);
+  ShadowStore(r, value);
+  return value;
+}
+
+void BK4819_WriteRegister(BK4819_REGISTER_t reg, uint16_t Data) {
+  uint8_t r = reg & 0x7F;
+  if (batch.depth && !IsOrderedReg(r)) {
+    BatchPut(r, Data);
+    return;
+  }
+  TRACE_SITE();
+  BatchFlush();
+  // программный сброс возвращает значения по умолчанию
+  if (r == BK4819_REG_00 && (Data & 0x8000))
+    ShadowInvalidate();
+  else
+    ShadowStore(r, Data);
+  BusWrite(reg, Data);
+  TraceBus(r, Data, BK4819_TRACE_WRITE);
+}
+
+uint32_t BK4819_GetShadowHits(void) { return shadowHits; }
 
 uint16_t BK4819_GetRegValue(RegisterSpec spec) {
   return (BK4819_ReadRegister(spec.num) >> spec.offset) & spec.mask;
@@ -480,26 +745,25 @@ void BK4819_SetFilterBandwidth(BK4819_FilterBandwidth_t bw) {
 // Frequency Management
 // ============================================================================
 
-void BK4819_SetFrequency(uint32_t freq) {
-  static uint16_t prev_low = 0;
-  static uint16_t prev_high = 0;
-
-  freq += gSettings.freqCorrection;
-
-  uint16_t low = freq & 0xFFFF;
-  uint16_t high = (freq >> 16) & 0xFFFF;
+static uint16_t pllLow, pllHigh; // последние записанные REG_38/39
 
-  if (low != prev_low) {
+static void SetPllWords(uint16_t low, uint16_t high) {
+  if (low != pllLow) {
     BK4819_WriteRegister(BK4819_REG_38, low);
-    prev_low = low;
+    pllLow = low;
   }
 
-  if (high != prev_high) {
+  if (high != pllHigh) {
     BK4819_WriteRegister(BK4819_REG_39, high);
-    prev_high = high;
+    pllHigh = high;
   }
 }
 
+void BK4819_SetFrequency(uint32_t freq) {
+  freq += gSettings.freqCorrection;
+  SetPllWords(freq & 0xFFFF, (freq >> 16) & 0xFFFF);
+}
+
 uint32_t BK4819_GetFrequency(void) {
   return (BK4819_ReadRegister(BK4819_REG_39) << 16) |
          BK4819_ReadRegister(BK4819_REG_38);
@@ -521,6 +785,26 @@ void BK4819_TuneTo(uint32_t freq, bool precise) {
   BK4819_WriteRegister(BK4819_REG_30, reg);
 }
 
+void BK4819_PlanTune(BK4819_PlannedTune *t, uint32_t freq, bool autoFilter) {
+  t->filter = !autoFilter                          ? BK4819_FILTER_KEEP
+              : freq < SETTINGS_GetFilterBound() ? FILTER_VHF
+                                                 : FILTER_UHF;
+  freq += gSettings.freqCorrection;
+  t->pllLow = freq & 0xFFFF;
+  t->pllHigh = (freq >> 16) & 0xFFFF;
+}
+
+void BK4819_TunePlanned(const BK4819_PlannedTune *t) {
+  if (t->filter != BK4819_FILTER_KEEP)
+    BK4819_SelectFilterEx(t->filter);
+  SetPllWords(t->pllLow, t->pllHigh);
+
+  uint16_t reg = BK4819_ReadRegister(BK4819_REG_30) |
+                 BK4819_REG_30_ENABLE_PLL_VCO;
+  BK4819_WriteRegister(BK4819_REG_30, reg & ~BK4819_REG_30_ENABLE_VCO_CALIB);
+  BK4819_WriteRegister(BK4819_REG_30, reg);
+}
+
 // ============================================================================
 // Modulation
 // ============================================================================
@@ -650,20 +934,33 @@ void BK4819_SetModulation(ModulationType type) {
 // Squelch
 // ============================================================================
 
-void BK4819_SetupSquelch(SQL sq, uint8_t delayOpen, uint8_t delayClose) {
+static void SquelchWords(BK4819_SquelchWords *w, SQL sq, uint8_t delayOpen,
+                         uint8_t delayClose) {
   sq.no = Clamp(sq.no, 0, 127);
   sq.nc = Clamp(sq.nc, 0, 127);
 
-  BK4819_WriteRegister(BK4819_REG_4D, 0xA000 | sq.gc);
-  BK4819_WriteRegister(BK4819_REG_4E, (1u << 14) | (delayOpen << 11) |
-                                          (delayClose << 9) | (1 << 8) | sq.go);
+  w->r4D = 0xA000 | sq.gc;
+  w->r4E = (1u << 14) | (delayOpen << 11) | (delayClose << 9) | (1 << 8) | sq.go;
+  w->r4F = (sq.nc << 8) | sq.no;
+  w->r78 = (sq.ro << 8) | sq.rc;
+}
 
-  BK4819_WriteRegister(BK4819_REG_4F, (sq.nc << 8) | sq.no);
-  BK4819_WriteRegister(BK4819_REG_78, (sq.ro << 8) | sq.rc);
+void BK4819_ApplySquelch(const BK4819_SquelchWords *w) {
+  BK4819_WriteRegister(BK4819_REG_4D, w->r4D);
+  BK4819_WriteRegister(BK4819_REG_4E, w->r4E);
+  BK4819_WriteRegister(BK4819_REG_4F, w->r4F);
+  BK4819_WriteRegister(BK4819_REG_78, w->r78);
 }
 
-void BK4819_Squelch(uint8_t sql, uint32_t freq, uint8_t openDelay,
-                    uint8_t closeDelay) {
+void BK4819_SetupSquelch(SQL sq, uint8_t delayOpen, uint8_t delayClose) {
+  BK4819_SquelchWords w;
+  SquelchWords(&w, sq, delayOpen, delayClose);
+  BK4819_ApplySquelch(&w);
+}
+
+// пресет читается с флеша — для плана считаем один раз
+void BK4819_PlanSquelch(BK4819_SquelchWords *w, uint8_t sql, uint32_t freq,
+                        uint8_t openDelay, uint8_t closeDelay) {
   SquelchPreset preset = GetSqlPreset(sql, freq);
   SQL sq = {
       .ro = preset.ro,
@@ -673,7 +970,14 @@ void BK4819_Squelch(uint8_t sql, uint32_t freq, uint8_t openDelay,
       .go = preset.go,
       .gc = preset.gc,
   };
-  BK4819_SetupSquelch(sq, openDelay, closeDelay);
+  SquelchWords(w, sq, openDelay, closeDelay);
+}
+
+void BK4819_Squelch(uint8_t sql, uint32_t freq, uint8_t openDelay,
+                    uint8_t closeDelay) {
+  BK4819_SquelchWords w;
+  BK4819_PlanSquelch(&w, sql, freq, openDelay, closeDelay);
+  BK4819_ApplySquelch(&w);
 }
 
 void BK4819_SquelchType(SquelchType type) {
@@ -1374,6 +1678,25 @@ int16_t BK4819_GetAFCValue() {
 
 uint8_t BK4819_GetSNR(void) { return BK4819_ReadRegister(0x61) & 0xFF; }
 
+// RSSI, шум, глитчи (и SNR) одной пачкой — замеры почти одновременные,
+// шина и CS дёргаются меньше. Маски как у BK4819_GetXxx
+void BK4819_ReadMeasurementBurst(Measurement *m, bool withSnr) {
+  static const uint8_t REGS[] = {BK4819_REG_67, BK4819_REG_65, BK4819_REG_63,
+                                 0x61};
+  uint16_t v[4];
+  uint8_t n = withSnr ? 4 : 3;
+  TRACE_SITE();
+  BatchFlush();
+  BusReadBurst(REGS, v, n);
+  for (uint8_t i = 0; i < n; ++i)
+    TraceBus(REGS[i], v[i], i ? BK4819_TRACE_BURST : 0);
+  m->rssi = v[0] & 0x1FF;
+  m->noise = v[1] & 0x7F;
+  m->glitch = v[2] & 0xFF;
+  if (withSnr)
+    m->snr = v[3] & 0xFF;
+}
+
 // ============================================================================
 // Frequency Scanning
 // ============================================================================
@@ -1494,10 +1817,15 @@ void BK4819_Init(void) {
   }
   gSelectedFilter = 255;
   gLastModulation = 255;
+#ifdef BK4819_TRACE
+  BK4819_TraceEnable(true);
+#endif
 
+#ifndef HOST_BUILD
   CS_Release();
   SCL_Set();
   SDA_Set();
+#endif
 
   BK4819_WriteRegister(BK4819_REG_00, 0x8000);
   BK4819_WriteRegister(BK4819_REG_00, 0x0000);
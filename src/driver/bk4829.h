@@ -2,6 +2,7 @@
 #define DRIVER_BK4819_h
 
 #include "../helper/measurements.h"
+#include "../inc/common.h"
 #include "bk4819-regs.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -104,6 +105,34 @@ extern const Gain GAIN_TABLE[32];
 void BK4819_Init(void);
 uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register);
 void BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data);
+uint32_t BK4819_GetShadowHits(void); // чтений, снятых теневой копией
+// Пакет записей: склейка повторов и отброс записей без изменений,
+// на шину при EndBatch (вложенные пакеты — по внешнему)
+void BK4819_BeginBatch(void);
+void BK4819_EndBatch(void);
+uint32_t BK4819_GetBatchSaved(void); // записей, снятых пакетами
+
+// Трассировка транзакций шины (сборка с -DBK4819_TRACE)
+#ifdef BK4819_TRACE
+#ifndef BK4819_TRACE_SIZE
+#define BK4819_TRACE_SIZE 128 // 12 байт на запись
+#endif
+#define BK4819_TRACE_WRITE 0x01
+#define BK4819_TRACE_BURST 0x02 // не первый регистр пачки чтений
+
+typedef struct {
+  uint32_t t;  // HRTIME_Now()
+  uint32_t pc; // непосредственный вызывающий функции шины
+  uint16_t value;
+  uint8_t reg;
+  uint8_t flags;
+} BK4819_TraceRec;
+
+void BK4819_TraceEnable(bool on); // включение очищает кольцо
+uint16_t BK4819_TraceCount(void);
+uint32_t BK4819_TraceLost(void);
+const BK4819_TraceRec *BK4819_TraceGet(uint16_t i); // 0 — самая старая
+#endif
 void BK4819_WriteU8(uint8_t Data);
 void BK4819_WriteU16(uint16_t Data);
 
@@ -126,6 +155,28 @@ void BK4819_Squelch(uint8_t sql, uint32_t freq, uint8_t OpenDelay,
                     uint8_t CloseDelay);
 void BK4819_SquelchType(SquelchType t);
 
+// Перестройка, посчитанная заранее (план сканера): слова PLL уже с
+// freqCorrection, фильтр выбран, шумодав — готовые значения регистров
+typedef struct {
+  uint16_t pllLow;  // REG_38
+  uint16_t pllHigh; // REG_39
+  uint8_t filter;   // Filter, BK4819_FILTER_KEEP — не трогать
+} BK4819_PlannedTune;
+
+#define BK4819_FILTER_KEEP 0xFF
+
+typedef struct {
+  uint16_t r4D, r4E, r4F, r78;
+} BK4819_SquelchWords;
+
+// autoFilter — фильтр по частоте (FILTER_AUTO), иначе выбранный не трогаем
+void BK4819_PlanTune(BK4819_PlannedTune *t, uint32_t f, bool autoFilter);
+// Как TuneTo(f, false) с включением VCO в той же записи REG_30
+void BK4819_TunePlanned(const BK4819_PlannedTune *t);
+void BK4819_PlanSquelch(BK4819_SquelchWords *w, uint8_t sql, uint32_t f,
+                        uint8_t openDelay, uint8_t closeDelay);
+void BK4819_ApplySquelch(const BK4819_SquelchWords *w);
+
 void BK4819_SetAF(BK4819_AF_Type_t AF);
 void BK4819_RX_TurnOn(void);
 void BK4819_SelectFilterEx(Filter filter);
@@ -177,6 +228,8 @@ uint8_t BK4819_GetLowerChannelRelativePower(void);
 uint8_t BK4819_GetNoise(void);
 uint8_t BK4819_GetGlitch(void);
 uint8_t BK4819_GetSNR(void);
+// rssi/noise/glitch (+ сырой snr) за одну критическую секцию
+void BK4819_ReadMeasurementBurst(Measurement *m, bool withSnr);
 uint16_t BK4819_GetVoiceAmplitude(void);
 uint8_t BK4819_GetAfTxRx(void);
 uint8_t BK4819_GetSignalPower(void);
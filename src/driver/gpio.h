@@ -6,7 +6,7 @@
 #include <stdint.h>
 
 #define GPIO_MAKE_PIN(Port, PinMask)                                           \
-  ((uint32_t)((((uint32_t)(Port)) << 16) | (0xffff & (PinMask))))
+  ((uint32_t)((((uint32_t)(uintptr_t)(Port)) << 16) | (0xffff & (PinMask))))
 #define GPIO_PORT(Pin) ((GPIO_TypeDef *)(IOPORT_BASE + ((Pin) >> 16)))
 #define GPIO_PIN_MASK(Pin) (0xffff & (Pin))
 
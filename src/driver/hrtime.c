@@ -6,9 +6,12 @@
  * TIM2 is configured as a free-running up-counter at 48 MHz.
  * - Prescaler: 0 (count every APB clock = 48 MHz cycle)
  * - Auto-reload: 0xFFFFFFFF (32-bit, wraps every ~89 seconds)
- * - No output compare, no interrupts — just a running counter.
+ * - CC1 in frozen output-compare mode drives the one-shot sequencer
+ *   (HRTIME_ScheduleAt); its interrupt is the only one TIM2 raises.
  */
 
+static volatile HRTIME_Callback pendingCb;
+
 void HRTIME_Init(void) {
   /* Enable TIM2 clock */
   LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM2);
@@ -32,6 +35,9 @@ void HRTIME_Init(void) {
 
   /* Start the counter */
   LL_TIM_EnableCounter(TIM2);
+
+  NVIC_SetPriority(TIM2_IRQn, 1);
+  NVIC_EnableIRQ(TIM2_IRQn);
 }
 
 uint32_t HRTIME_Now(void) { return LL_TIM_GetCounter(TIM2); }
@@ -45,3 +51,41 @@ void HRTIME_DelayUs(uint32_t us) {
     /* spin — precise, no interrupt latency */
   }
 }
+
+void HRTIME_ScheduleAt(uint32_t deadline, HRTIME_Callback cb) {
+  LL_TIM_DisableIT_CC1(TIM2);
+  pendingCb = cb;
+  LL_TIM_OC_SetCompareCH1(TIM2, deadline);
+  LL_TIM_ClearFlag_CC1(TIM2);
+  LL_TIM_EnableIT_CC1(TIM2);
+
+  /* Compare fires only on CNT == CCR1: a deadline that slipped past while
+   * we were arming it would wait for the next wrap (~89 s). */
+  if ((int32_t)(LL_TIM_GetCounter(TIM2) - deadline) >= 0) {
+    NVIC_SetPendingIRQ(TIM2_IRQn);
+  }
+}
+
+void HRTIME_Cancel(void) {
+  LL_TIM_DisableIT_CC1(TIM2);
+  LL_TIM_ClearFlag_CC1(TIM2);
+  pendingCb = 0;
+}
+
+void TIM2_IRQHandler(void) {
+  LL_TIM_ClearFlag_CC1(TIM2);
+  if (!LL_TIM_IsEnabledIT_CC1(TIM2)) {
+    return;
+  }
+  /* Pended by HRTIME_ScheduleAt or a real match — both mean CNT >= CCR1 */
+  if ((int32_t)(LL_TIM_GetCounter(TIM2) - LL_TIM_OC_GetCompareCH1(TIM2)) < 0) {
+    return;
+  }
+  LL_TIM_DisableIT_CC1(TIM2);
+
+  HRTIME_Callback cb = pendingCb;
+  pendingCb = 0;
+  if (cb) {
+    cb();
+  }
+}
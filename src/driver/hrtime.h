@@ -11,6 +11,12 @@
 
 #include <stdint.h>
 
+/**
+ * One-shot callback fired from the TIM2 CC1 interrupt.
+ * Runs in interrupt context: set a flag, do not touch the BK4819 bus.
+ */
+typedef void (*HRTIME_Callback)(void);
+
 /**
  * Initialize TIM2 as a free-running 48 MHz counter.
  * Call once during system startup.
@@ -63,4 +69,24 @@ static inline uint32_t HRTIME_TicksToUs(uint32_t ticks) {
   return ticks / 48u;
 }
 
+/**
+ * Arm a one-shot callback at an absolute TIM2 timestamp.
+ * Re-arming replaces the pending callback. A deadline that has already
+ * passed fires immediately (via a pended TIM2 interrupt).
+ * The interrupt also wakes the core from __WFI().
+ */
+void HRTIME_ScheduleAt(uint32_t deadline, HRTIME_Callback cb);
+
+/**
+ * Arm a one-shot callback `us` microseconds from now.
+ */
+static inline void HRTIME_Schedule(uint32_t us, HRTIME_Callback cb) {
+  HRTIME_ScheduleAt(HRTIME_Now() + HRTIME_UsToTicks(us), cb);
+}
+
+/**
+ * Disarm the pending callback, if any.
+ */
+void HRTIME_Cancel(void);
+
 #endif // DRIVER_HRTIME_H
@@ -25,7 +25,7 @@ typedef struct {
   bool physical_state; // Текущее физическое состояние
 } key_context_t;
 
-const char *KEY_NAMES[] = {
+const char *const KEY_NAMES[] = {
     [KEY_NONE] = "NONE",   [KEY_MENU] = "MENU", [KEY_UP] = "UP",
     [KEY_DOWN] = "DOWN",   [KEY_EXIT] = "EXIT", [KEY_0] = "0",
     [KEY_1] = "1",         [KEY_2] = "2",       [KEY_3] = "3",
@@ -9,14 +9,136 @@ lfs_t gLfs;
 // Глобальные буферы
 uint8_t lfs_read_buffer[LFS_CACHE_SIZE];
 uint8_t lfs_prog_buffer[LFS_CACHE_SIZE];
-uint8_t lfs_lookahead_buffer[LFS_LOOKAHEAD_SIZE / 8];
+uint8_t lfs_lookahead_buffer[LFS_LOOKAHEAD_SIZE]; // lookahead_size — в байтах
+
+// Известно стёртые хвосты блоков. После стирания lfs пишет блок по
+// возрастанию адреса, поэтому хватает "стёрто от from до конца"; в работе
+// одновременно немного блоков (пара метаданных, данные открытых файлов)
+#define ERASED_TRACK 8
+#define ERASED_NONE 0xFFFF
+
+typedef struct {
+  uint16_t block;
+  uint16_t from; // смещение, с которого блок ещё стёрт
+} ErasedTail;
+
+static ErasedTail erased[ERASED_TRACK];
+static uint8_t erasedNext;
+
+static ErasedTail *Erased_Find(lfs_block_t block) {
+  for (uint8_t i = 0; i < ERASED_TRACK; ++i) {
+    if (erased[i].block == block)
+      return &erased[i];
+  }
+  return NULL;
+}
+
+static void Erased_Set(lfs_block_t block, lfs_off_t from) {
+  ErasedTail *e = Erased_Find(block);
+  if (!e) {
+    e = &erased[erasedNext];
+    erasedNext = (erasedNext + 1) % ERASED_TRACK;
+    e->block = block;
+  }
+  e->from = from;
+}
+
+// ============================================================================
+// Кеш чтения: несколько страниц с LRU. lfs читает страницами (read_size),
+// а метаданные каталогов и суперблок — одни и те же страницы снова и снова.
+// Запись обновляет закешированную страницу, стирание её выбрасывает
+// ============================================================================
+
+#if LFS_READ_LINES
+#define LINE_NONE 0xFFFFFFFF
+
+typedef struct {
+  uint32_t addr; // адрес страницы, LINE_NONE — пусто
+  uint32_t used;
+  uint8_t data[LFS_READ_SIZE];
+} ReadLine;
+
+static ReadLine lines[LFS_READ_LINES];
+static uint32_t lineClock;
+
+static ReadLine *Line_Find(uint32_t addr) {
+  for (uint8_t i = 0; i < LFS_READ_LINES; ++i) {
+    if (lines[i].addr == addr)
+      return &lines[i];
+  }
+  return NULL;
+}
+
+static ReadLine *Line_Get(uint32_t addr) {
+  ReadLine *l = Line_Find(addr);
+  if (l) {
+    gStorage.read_hits++;
+  } else {
+    l = &lines[0];
+    for (uint8_t i = 1; i < LFS_READ_LINES; ++i) {
+      if (lines[i].used < l->used)
+        l = &lines[i];
+    }
+    PY25Q16_ReadBuffer(addr, l->data, LFS_READ_SIZE);
+    l->addr = addr;
+    gStorage.read_misses++;
+  }
+  l->used = ++lineClock;
+  return l;
+}
+
+// NOR: запись только сбрасывает биты — в строке то же, что на флеше
+static void Line_Program(uint32_t addr, const uint8_t *buf, uint32_t size) {
+  for (uint32_t done = 0; done < size;) {
+    uint32_t a = addr + done;
+    uint32_t in = a % LFS_READ_SIZE;
+    uint32_t n = LFS_READ_SIZE - in;
+    if (n > size - done)
+      n = size - done;
+    ReadLine *l = Line_Find(a - in);
+    if (l) {
+      for (uint32_t i = 0; i < n; ++i)
+        l->data[in + i] &= buf[done + i];
+    }
+    done += n;
+  }
+}
+
+static void Line_Erase(uint32_t addr, uint32_t size) {
+  for (uint8_t i = 0; i < LFS_READ_LINES; ++i) {
+    if (lines[i].addr != LINE_NONE && lines[i].addr - addr < size)
+      lines[i].addr = LINE_NONE;
+  }
+}
+
+static void Line_Reset(void) {
+  for (uint8_t i = 0; i < LFS_READ_LINES; ++i) {
+    lines[i].addr = LINE_NONE;
+    lines[i].used = 0;
+  }
+}
+#else
+static void Line_Program(uint32_t addr, const uint8_t *buf, uint32_t size) {}
+static void Line_Erase(uint32_t addr, uint32_t size) {}
+static void Line_Reset(void) {}
+#endif
 
 // Чтение блока
 static int lfs_read(const struct lfs_config *c, lfs_block_t block,
                     lfs_off_t off, void *buffer, lfs_size_t size) {
   uint32_t addr = block * c->block_size + off;
-  PY25Q16_ReadBuffer(addr, buffer, size);
   gStorage.read_count++;
+#if LFS_READ_LINES
+  // по странице — через кеш; длинное чтение данных файла в обход, чтобы
+  // не вытеснять метаданные
+  if (size <= LFS_READ_SIZE && addr % LFS_READ_SIZE + size <= LFS_READ_SIZE) {
+    ReadLine *l = Line_Get(addr - addr % LFS_READ_SIZE);
+    memcpy(buffer, l->data + addr % LFS_READ_SIZE, size);
+    return 0;
+  }
+  gStorage.read_misses++;
+#endif
+  PY25Q16_ReadBuffer(addr, buffer, size);
   return 0;
 }
 
@@ -25,6 +147,18 @@ static int lfs_prog(const struct lfs_config *c, lfs_block_t block,
                     lfs_off_t off, const void *buffer, lfs_size_t size) {
   uint32_t addr = block * c->block_size + off;
 
+  // пишем в заведомо стёртое — проверочное чтение не нужно
+  ErasedTail *e = Erased_Find(block);
+  if (e && off >= e->from) {
+    e->from = off + size;
+    PY25Q16_WriteBuffer(addr, (uint8_t *)buffer, size, true);
+    Line_Program(addr, buffer, size);
+    gStorage.prog_count++;
+    gStorage.prog_fast++;
+    return 0;
+  }
+  gStorage.prog_checked++;
+
   // Проверяем, нужно ли стирание
   uint8_t current[256];
   bool needs_erase = false;
@@ -49,10 +183,14 @@ static int lfs_prog(const struct lfs_config *c, lfs_block_t block,
     // Стираем весь блок
     PY25Q16_SectorErase(block * c->block_size);
     gStorage.erase_count++;
+    gStorage.prog_erased++;
+    Erased_Set(block, off + size);
+    Line_Erase(block * c->block_size, c->block_size);
   }
 
   // Записываем данные
   PY25Q16_WriteBuffer(addr, (uint8_t *)buffer, size, true);
+  Line_Program(addr, buffer, size);
   gStorage.prog_count++;
   return 0;
 }
@@ -61,6 +199,8 @@ static int lfs_prog(const struct lfs_config *c, lfs_block_t block,
 static int lfs_erase(const struct lfs_config *c, lfs_block_t block) {
   PY25Q16_SectorErase(block * c->block_size);
   gStorage.erase_count++;
+  Erased_Set(block, 0);
+  Line_Erase(block * c->block_size, c->block_size);
   return 0;
 }
 
@@ -72,6 +212,11 @@ static int lfs_sync(const struct lfs_config *c) {
 
 int lfs_storage_init(lfs_storage_t *storage) {
   memset(storage, 0, sizeof(lfs_storage_t));
+  // до первого стирания после загрузки о стёртом ничего не знаем
+  for (uint8_t i = 0; i < ERASED_TRACK; ++i)
+    erased[i].block = ERASED_NONE;
+  erasedNext = 0;
+  Line_Reset();
 
   // Настраиваем конфигурацию
   storage->config.context = NULL;
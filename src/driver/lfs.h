@@ -13,6 +13,9 @@
 #define LFS_PROG_SIZE 256  // Размер программирования
 #define LFS_CACHE_SIZE 256 // Размер кеша
 #define LFS_LOOKAHEAD_SIZE 32 // Для поиска свободных блоков
+#ifndef LFS_READ_LINES
+#define LFS_READ_LINES 2 // Кеш чтения: строк по LFS_READ_SIZE (0 — без кеша)
+#endif
 
 // Структура для LittleFS
 typedef struct {
@@ -23,6 +26,11 @@ typedef struct {
   uint32_t read_count;
   uint32_t prog_count;
   uint32_t erase_count;
+  uint32_t prog_fast;    // в известно стёртое — без проверочного чтения
+  uint32_t prog_checked; // с чтением: блок не из числа недавно стёртых
+  uint32_t prog_erased;  // проверка нашла не-FF — блок стирали сами
+  uint32_t read_hits;    // страниц из кеша чтения
+  uint32_t read_misses;  // страниц с флеша
 } lfs_storage_t;
 
 // Функции инициализации
@@ -21,14 +21,15 @@
 
 bool gEepromWrite = false;
 
-static uint32_t SectorCacheAddr = 0x1000000;
-static uint8_t SectorCache[SECTOR_SIZE];
 static uint8_t BlackHole[1];
 static volatile bool TC_Flag;
 
 static uint32_t last_operation_time = 0;
 static uint32_t operation_count = 0;
 
+static PY25Q16_QuietFn quietFn;
+static bool fastClock;
+
 static inline void CS_Assert() { GPIO_ResetOutputPin(CS_PIN); }
 
 static inline void CS_Release() { GPIO_SetOutputPin(CS_PIN); }
@@ -83,6 +84,29 @@ static void SPI_Init() {
   LL_SPI_Enable(SPIx);
 }
 
+// DIV2 + VERY_HIGH (24 MHz) — только пока приёмник не меряет: гармоники
+// шины попадают в RSSI. Всё остальное время — DIV8 + MEDIUM из SPI_Init
+static void SPI_SetFast(bool fast) {
+  if (fast == fastClock)
+    return;
+  fastClock = fast;
+
+  while (LL_SPI_IsActiveFlag_BSY(SPIx))
+    ;
+  LL_SPI_Disable(SPIx);
+  LL_SPI_SetBaudRatePrescaler(SPIx, fast ? LL_SPI_BAUDRATEPRESCALER_DIV2
+                                         : LL_SPI_BAUDRATEPRESCALER_DIV8);
+  uint32_t speed =
+      fast ? LL_GPIO_SPEED_FREQ_VERY_HIGH : LL_GPIO_SPEED_FREQ_MEDIUM;
+  LL_GPIO_SetPinSpeed(GPIOA, LL_GPIO_PIN_0, speed); // SCK
+  LL_GPIO_SetPinSpeed(GPIOA, LL_GPIO_PIN_1, speed); // MOSI
+  LL_GPIO_SetPinSpeed(GPIOA, LL_GPIO_PIN_2, speed); // MISO
+  LL_SPI_Enable(SPIx);
+}
+
+// Скорость выбирается на каждую операцию: между ними сканер мог начать замер
+static void SPI_SelectClock(void) { SPI_SetFast(quietFn && quietFn()); }
+
 // УПРОЩЕННАЯ функция SPI_ReadBuf без таймаута в основном цикле
 static void SPI_ReadBuf(uint8_t *Buf, uint32_t Size) {
   LL_SPI_Disable(SPIx);
@@ -309,8 +333,11 @@ void PY25Q16_Init() {
   SPI_Init();
 }
 
+void PY25Q16_SetQuietFn(PY25Q16_QuietFn fn) { quietFn = fn; }
+
 // py25q16.c - оптимизированное чтение
 void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size) {
+  SPI_SelectClock();
   CS_Assert();
 
   // Быстрое чтение с dummy byte (стандарт)
@@ -369,6 +396,7 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
     uint32_t delay = 20 - (now - last_operation_time);
     SYSTICK_DelayMs(delay);
   }
+  SPI_SelectClock();
 
   const uint8_t *ptr = (const uint8_t *)pBuffer;
   uint32_t written = 0;
@@ -420,6 +448,7 @@ void PY25Q16_SectorErase(uint32_t Address) {
   }
 
   operation_count++;
+  SPI_SelectClock();
 
   // Выполняем стирание
   WriteEnable();
@@ -6,15 +6,17 @@
 
 extern bool gEepromWrite;
 
+// true — приёмник сейчас ничего не меряет, шину можно гнать на полной
+// скорости. Без проверки (и пока она false) — медленный клок SPI_Init
+typedef bool (*PY25Q16_QuietFn)(void);
+
 void PY25Q16_Init();
 void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size);
 void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
                          bool Append);
 void PY25Q16_SectorErase(uint32_t Address);
 void PY25Q16_FullErase();
-
-static uint8_t PY25Q16_ReadStatus(void);
-static void PY25Q16_WaitBusy(void);
+void PY25Q16_SetQuietFn(PY25Q16_QuietFn fn);
 
 void test_flash_basic(void);
 bool test_flash_simple(void);
@@ -18,6 +18,7 @@
 uint8_t gFrameBuffer[FRAME_LINES][LCD_WIDTH];
 bool gLineChanged[FRAME_LINES]; // выставляется в graphics.c примитивами
 bool gRedrawScreen = true;
+uint32_t gLastRender;
 bool gSuppressDisplayUpdates = false; // подавление обновлей дисплея
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+#include "bandfloor.h"
+#include "persist.h"
+#include "storage.h"
+#include <string.h>
+
+#define BANDFLOOR_FILE "Floor.cal"
+#define BANDFLOOR_SAVE_DELAY_MS 1000
+
+typedef struct {
+  BandFloor items[BANDFLOOR_MAX];
+  uint8_t next; // куда писать новый диапазон, когда свободных нет
+} FloorTable;
+
+static FloorTable table;
+static bool loaded;
+
+static void Load(void) {
+  if (loaded)
+    return;
+  loaded = true;
+  if (!STORAGE_LOAD(BANDFLOOR_FILE, 0, &table))
+    memset(&table, 0, sizeof(table));
+  // файл от таблицы на 16 диапазонов: первые 8 те же, next — мусор
+  if (table.next >= BANDFLOOR_MAX)
+    table.next = 0;
+}
+
+static BandFloor *Find(uint32_t start, uint32_t end) {
+  Load();
+  for (uint8_t i = 0; i < BANDFLOOR_MAX; ++i) {
+    BandFloor *p = &table.items[i];
+    if (p->end && p->start == start && p->end == end)
+      return p;
+  }
+  return NULL;
+}
+
+static void Save(void) { STORAGE_SAVE(BANDFLOOR_FILE, 0, &table); }
+
+bool BANDFLOOR_Get(uint32_t start, uint32_t end, BandFloor *out) {
+  BandFloor *p = Find(start, end);
+  if (p)
+    *out = *p;
+  return p != NULL;
+}
+
+void BANDFLOOR_Set(const BandFloor *floor) {
+  BandFloor *p = Find(floor->start, floor->end);
+  if (!p) {
+    p = &table.items[table.next];
+    table.next = (table.next + 1) % BANDFLOOR_MAX;
+  }
+  *p = *floor;
+  // калибровка кончается посреди прохода — запись в окно без замеров
+  PERSIST_Mark(Save, BANDFLOOR_SAVE_DELAY_MS);
+}
+
+void BANDFLOOR_Forget(uint32_t start, uint32_t end) {
+  BandFloor *p = Find(start, end);
+  if (!p)
+    return;
+  memset(p, 0, sizeof(*p));
+  PERSIST_Mark(Save, BANDFLOOR_SAVE_DELAY_MS);
+}
@@ -0,0 +1,23 @@
+#ifndef BANDFLOOR_H
+#define BANDFLOOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Сохранённый пол RSSI для диапазонов (детектор SCAN_ALGO_CALIBRATED).
+// Ключ — точные границы диапазона, хранится в LFS (Floor.cal).
+
+#define BANDFLOOR_MAX 8 // откалиброванных диапазонов, старые вытесняются по кругу
+
+typedef struct {
+  uint32_t start;
+  uint32_t end;
+  uint8_t mean;   // средний RSSI фона
+  uint8_t stddev; // разброс фона
+} BandFloor;
+
+bool BANDFLOOR_Get(uint32_t start, uint32_t end, BandFloor *out);
+void BANDFLOOR_Set(const BandFloor *floor); // запись отложенная (PERSIST)
+void BANDFLOOR_Forget(uint32_t start, uint32_t end);
+
+#endif
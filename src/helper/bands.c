@@ -582,7 +582,7 @@ const Band defaultBands[] = {
 
 static const PowerCalibration DEFAULT_POWER_CALIB = {43, 68, 140};
 
-PCal POWER_CALIBRATIONS[] = {
+static const PCal POWER_CALIBRATIONS[] = {
     {.s = 135 * MHZ, .e = 165 * MHZ, .c = {38, 65, 140}},
     {.s = 165 * MHZ, .e = 205 * MHZ, .c = {36, 52, 140}},
     {.s = 205 * MHZ, .e = 215 * MHZ, .c = {41, 64, 135}},
@@ -0,0 +1,77 @@
+#include "bktrace.h"
+
+#ifdef BK4819_TRACE
+#include "../driver/bk4829.h"
+#include "../driver/hrtime.h"
+#include "../driver/lfs.h"
+#include "../driver/uart.h"
+#include "../external/printf/printf.h"
+#include "storage.h"
+#include <string.h>
+
+#define BKTRACE_LINE 48
+
+void BKTRACE_Write(BKTRACE_Sink sink, void *ctx) {
+  char line[BKTRACE_LINE];
+  // обращения к BK4819 из самой выгрузки (UART, флеш) в трассу не пишем
+  BK4819_TraceEnable(false);
+
+  uint16_t n = BK4819_TraceCount();
+  snprintf(line, sizeof(line), "BKT0 %lx %x %lx\n",
+           (unsigned long)HRTIME_UsToTicks(1000), n,
+           (unsigned long)BK4819_TraceLost());
+  sink(line, ctx);
+
+  for (uint16_t i = 0; i < n; ++i) {
+    const BK4819_TraceRec *r = BK4819_TraceGet(i);
+    snprintf(line, sizeof(line), "BKT %lx %lx %x %02x %04x\n",
+             (unsigned long)r->t, (unsigned long)r->pc, r->flags, r->reg,
+             r->value);
+    sink(line, ctx);
+  }
+
+  BK4819_TraceEnable(true);
+}
+
+// ============================================================================
+// UART
+// ============================================================================
+
+static void UartSink(const char *line, void *ctx) { LogUart(line); }
+
+void BKTRACE_DumpUart(void) { BKTRACE_Write(UartSink, NULL); }
+
+// ============================================================================
+// Файл на LFS
+// ============================================================================
+
+typedef struct {
+  lfs_file_t file;
+  bool ok;
+} FileSink;
+
+static void LfsSink(const char *line, void *ctx) {
+  FileSink *fs = ctx;
+  if (!fs->ok)
+    return;
+  lfs_size_t len = strlen(line);
+  fs->ok = lfs_file_write(&gLfs, &fs->file, line, len) == (lfs_ssize_t)len;
+}
+
+bool BKTRACE_Save(const char *path) {
+  uint8_t buffer[256];
+  struct lfs_file_config config = {.buffer = buffer, .attr_count = 0};
+  FileSink fs = {.ok = true};
+
+  Storage_Close(path);
+  int err = lfs_file_opencfg(&gLfs, &fs.file, path,
+                             LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, &config);
+  if (err < 0) {
+    Log("[BKT] Failed to create %s: %d", path, err);
+    return false;
+  }
+  BKTRACE_Write(LfsSink, &fs);
+  lfs_file_close(&gLfs, &fs.file);
+  return fs.ok;
+}
+#endif
@@ -0,0 +1,23 @@
+#ifndef BKTRACE_H
+#define BKTRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Выгрузка трассы шины BK4819 (сборка с -DBK4819_TRACE) в текстовом виде:
+//
+//   BKT0 <тиков на мс> <записей> <затёрто>
+//   BKT <t> <pc> <флаги> <рег> <значение>      (hex, старые первыми)
+//
+// Разбирает host/trace_replay.
+
+#ifdef BK4819_TRACE
+typedef void (*BKTRACE_Sink)(const char *line, void *ctx);
+
+// Трасса останавливается на время выгрузки и включается снова
+void BKTRACE_Write(BKTRACE_Sink sink, void *ctx);
+void BKTRACE_DumpUart(void);
+bool BKTRACE_Save(const char *path);
+#endif
+
+#endif // !BKTRACE_H
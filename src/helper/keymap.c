@@ -7,7 +7,7 @@
 
 AppKeymap_t gCurrentKeymap;
 
-const char *KA_NAMES[] = {
+const char *const KA_NAMES[] = {
     [KA_NONE] = "NONE",
 
     // Приложения
@@ -108,5 +108,5 @@ void KEYMAP_Load(void) {
 }
 
 void KEYMAP_Save(void) {
-  STORAGE_SAVE(keymapFile, 1, &gCurrentKeymap);
+  STORAGE_SAVE_CHANGED(keymapFile, 1, &gCurrentKeymap);
 }
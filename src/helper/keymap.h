@@ -105,6 +105,6 @@ void KEYMAP_Load(void);
 void KEYMAP_Save(void);
 
 extern AppKeymap_t gCurrentKeymap;
-extern const char *KA_NAMES[];
+extern const char *const KA_NAMES[];
 
 #endif // KEYMAP_H
@@ -8,20 +8,90 @@
 #include "bands.h"
 #include "storage.h"
 #include <stdint.h>
+#include <string.h>
 
 static Loot loot[LOOT_SIZE_MAX] = {0};
 static uint32_t lastTimeCheck = 0;
 static int16_t lootIndex = -1;
 
+// Индекс частота -> позиция в loot[]: открытая адресация, линейные пробы.
+// В ячейке позиция + 1, 0 — пусто (обнулённый .bss и есть пустой индекс).
+// Удалений по одному нет — после Remove/Sort/Load индекс строится заново
+// Ячеек — наименьшая степень двойки, не меньше LOOT_SIZE_MAX * 2
+#if LOOT_SIZE_MAX * 2 <= 64
+#define LOOT_HASH_BITS 6
+#elif LOOT_SIZE_MAX * 2 <= 128
+#define LOOT_HASH_BITS 7
+#elif LOOT_SIZE_MAX * 2 <= 256
+#define LOOT_HASH_BITS 8
+#else
+#define LOOT_HASH_BITS 9
+#endif
+#define LOOT_HASH_SIZE (1u << LOOT_HASH_BITS)
+_Static_assert(LOOT_SIZE_MAX < 255, "loot index must fit uint8");
+_Static_assert(LOOT_SIZE_MAX * 2 <= LOOT_HASH_SIZE, "loot hash too dense");
+
+static uint8_t hashSlots[LOOT_HASH_SIZE];
+
+// Порядок последних открытий: вытесняем самый давний.
+// lastTimeOpen (uint16 от Now()) заворачивается раз в 65 с — для LRU не годится
+static uint16_t openSeq[LOOT_SIZE_MAX];
+static uint16_t openSeqNow;
+
+// Активность: +LOOT_ACTIVITY_OPEN за каждое открытие, гасится
+// LOOT_DecayActivity. По ней сканер чаще навещает живые частоты
+#define LOOT_ACTIVITY_OPEN 16
+static uint8_t activity[LOOT_SIZE_MAX];
+
 Loot *gLastActiveLoot = NULL;
 int16_t gLastActiveLootIndex = -1;
 static uint32_t lastActiveLootF =
     0; // частота для восстановления указателя после сортировки
+static uint16_t skipVersion; // растёт при любом изменении black/white
+
+uint16_t LOOT_SkipVersion(void) { return skipVersion; }
+
+static uint16_t Hash(uint32_t f) {
+  return (f * 2654435761u) >> (32 - LOOT_HASH_BITS);
+}
+
+static void HashInsert(uint8_t i) {
+  uint16_t h = Hash(loot[i].f);
+  while (hashSlots[h])
+    h = (h + 1) & (LOOT_HASH_SIZE - 1);
+  hashSlots[h] = i + 1;
+}
+
+static void HashRebuild(void) {
+  memset(hashSlots, 0, sizeof(hashSlots));
+  for (uint16_t i = 0; i < LOOT_Size(); ++i)
+    HashInsert(i);
+}
+
+static void TouchOpen(uint16_t i) { openSeq[i] = ++openSeqNow; }
+
+static void AddActivity(uint16_t i) {
+  activity[i] = activity[i] > UINT8_MAX - LOOT_ACTIVITY_OPEN
+                    ? UINT8_MAX
+                    : activity[i] + LOOT_ACTIVITY_OPEN;
+}
+
+uint8_t LOOT_Activity(const Loot *item) { return activity[item - loot]; }
+
+void LOOT_DecayActivity(uint8_t halvings) {
+  if (halvings > 7) {
+    memset(activity, 0, sizeof(activity));
+    return;
+  }
+  for (uint16_t i = 0; i < LOOT_Size(); ++i)
+    activity[i] >>= halvings;
+}
 
 void LOOT_BlacklistLast(void) {
   if (gLastActiveLoot) {
     gLastActiveLoot->whitelist = false;
     gLastActiveLoot->blacklist = true;
+    skipVersion++;
   }
 }
 
@@ -29,25 +99,58 @@ void LOOT_WhitelistLast(void) {
   if (gLastActiveLoot) {
     gLastActiveLoot->blacklist = false;
     gLastActiveLoot->whitelist = true;
+    skipVersion++;
   }
 }
 
+void LOOT_ToggleBlacklist(Loot *item) {
+  item->whitelist = false;
+  item->blacklist = !item->blacklist;
+  skipVersion++;
+}
+
+void LOOT_ToggleWhitelist(Loot *item) {
+  item->blacklist = false;
+  item->whitelist = !item->whitelist;
+  skipVersion++;
+}
+
 Loot *LOOT_Get(uint32_t f) {
-  for (uint16_t i = 0; i < LOOT_Size(); ++i) {
-    if ((&loot[i])->f == f) {
-      return &loot[i];
+  for (uint16_t h = Hash(f); hashSlots[h];
+       h = (h + 1) & (LOOT_HASH_SIZE - 1)) {
+    Loot *item = &loot[hashSlots[h] - 1];
+    if (item->f == f) {
+      return item;
     }
   }
   return NULL;
 }
 
 int16_t LOOT_IndexOf(Loot *item) {
+  if (item < loot || item >= loot + LOOT_Size()) {
+    return -1;
+  }
+  return item - loot;
+}
+
+// Самый давно открывавшийся; black/white и активный держим до последнего —
+// их вытеснение вернуло бы частоту в скан
+static uint16_t EvictionVictim(void) {
+  int16_t best = -1, bestFlagged = -1;
+  uint16_t bestAge = 0, bestFlaggedAge = 0;
   for (uint16_t i = 0; i < LOOT_Size(); ++i) {
-    if (&loot[i] == item) {
-      return i;
+    uint16_t age = openSeqNow - openSeq[i];
+    if (loot[i].blacklist || loot[i].whitelist || &loot[i] == gLastActiveLoot) {
+      if (bestFlagged < 0 || age > bestFlaggedAge) {
+        bestFlagged = i;
+        bestFlaggedAge = age;
+      }
+    } else if (best < 0 || age > bestAge) {
+      best = i;
+      bestAge = age;
     }
   }
-  return -1;
+  return best >= 0 ? best : bestFlagged;
 }
 
 Loot *LOOT_AddEx(uint32_t f, bool reuse) {
@@ -57,9 +160,11 @@ Loot *LOOT_AddEx(uint32_t f, bool reuse) {
       return p;
     }
   }
-  if (LOOT_Size() < LOOT_SIZE_MAX) {
-    lootIndex++;
+  if (LOOT_Size() >= LOOT_SIZE_MAX) {
+    LOOT_Remove(EvictionVictim()); // новые — в конце списка, как и раньше
   }
+  lootIndex++;
+  skipVersion++;
   lastTimeCheck = Now();
   loot[lootIndex] = (Loot){
       .f = f,
@@ -68,6 +173,10 @@ Loot *LOOT_AddEx(uint32_t f, bool reuse) {
       .code = 0xFF,
       .open = true, // as we add it when open
   };
+  TouchOpen(lootIndex);
+  activity[lootIndex] = 0;
+  AddActivity(lootIndex);
+  HashInsert(lootIndex);
   return &loot[lootIndex];
 }
 
@@ -81,13 +190,44 @@ void LOOT_Remove(uint16_t i) {
     gLastActiveLootIndex = -1;
     lastActiveLootF = 0;
   }
-  for (; i < LOOT_Size() - 1; ++i)
-    loot[i] = loot[i + 1];
+  // указатель на активный сдвигается вместе с хвостом
+  if (gLastActiveLoot > &loot[i]) {
+    gLastActiveLoot--;
+    gLastActiveLootIndex--;
+  }
+  uint16_t tail = LOOT_Size() - 1 - i;
+  memmove(&loot[i], &loot[i + 1], tail * sizeof(Loot));
+  memmove(&openSeq[i], &openSeq[i + 1], tail * sizeof(openSeq[0]));
+  memmove(&activity[i], &activity[i + 1], tail * sizeof(activity[0]));
   lootIndex--;
+  skipVersion++;
+  HashRebuild();
+}
+
+// Правка частоты из списка: индекс и кэши пропусков — по новой частоте.
+// Запись с той же частотой уже есть — она уступает правленой
+uint16_t LOOT_SetFrequency(uint16_t i, uint32_t f) {
+  if (i >= LOOT_Size())
+    return i;
+  Loot *same = LOOT_Get(f);
+  if (same && same != &loot[i]) {
+    uint16_t j = same - loot;
+    LOOT_Remove(j);
+    if (j < i)
+      i--;
+  }
+  if (&loot[i] == gLastActiveLoot)
+    lastActiveLootF = f;
+  loot[i].f = f;
+  skipVersion++;
+  HashRebuild();
+  return i;
 }
 
 void LOOT_Clear(void) {
   lootIndex = -1;
+  skipVersion++;
+  memset(hashSlots, 0, sizeof(hashSlots));
   gLastActiveLoot = NULL;
   gLastActiveLootIndex = -1;
   lastActiveLootF = 0;
@@ -107,6 +247,16 @@ static void swap(Loot *a, Loot *b) {
   Loot tmp = *a;
   *a = *b;
   *b = tmp;
+
+  uint16_t *sa = &openSeq[a - loot], *sb = &openSeq[b - loot];
+  uint16_t s = *sa;
+  *sa = *sb;
+  *sb = s;
+
+  uint8_t *aa = &activity[a - loot], *ab = &activity[b - loot];
+  uint8_t act = *aa;
+  *aa = *ab;
+  *ab = act;
 }
 
 bool LOOT_SortByLastOpenTime(const Loot *a, const Loot *b) {
@@ -141,6 +291,7 @@ static void Sort(Loot *items, uint16_t n,
 
 void LOOT_Sort(bool (*compare)(const Loot *a, const Loot *b), bool reverse) {
   Sort(loot, LOOT_Size(), compare, reverse);
+  HashRebuild();
   // После сортировки указатель мог сместиться — восстанавливаем по частоте
   if (lastActiveLootF) {
     gLastActiveLoot = LOOT_Get(lastActiveLootF);
@@ -181,10 +332,12 @@ void LOOT_UpdateEx(Loot *item, Measurement *msm) {
     lastActiveLootF = item->f;
   }
   if (msm->open) {
+    if (!item->open)
+      AddActivity(item - loot);
     item->lastTimeOpen = Now();
+    TouchOpen(item - loot);
     uint32_t cd = 0;
     uint16_t ct = 0;
-    uint8_t Code = 0;
     BK4819_CssScanResult_t res = BK4819_GetCxCSSScanResult(&cd, &ct);
     msm->isCd = false;
     switch (res) {
@@ -205,8 +358,9 @@ void LOOT_UpdateEx(Loot *item, Measurement *msm) {
   item->code = msm->code;
   item->isCd = msm->isCd;
 
-  if (msm->blacklist) {
+  if (msm->blacklist && !item->blacklist) {
     item->blacklist = true;
+    skipVersion++;
   }
 
   item->modulation = RADIO_GetParam(ctx, PARAM_MODULATION);
@@ -232,6 +386,8 @@ void LOOT_RemoveBlacklisted(void) {
   for (uint16_t i = 0; i < LOOT_Size(); ++i) {
     if (loot[i].blacklist) {
       lootIndex = i;
+      skipVersion++;
+      HashRebuild();
       return;
     }
   }
@@ -315,6 +471,14 @@ bool LOOT_LoadFromFile(const char *filename) {
   // Load all loot items
   if (Storage_LoadMultiple(filename, 1, loot, sizeof(Loot), count)) {
     lootIndex = count - 1;
+    skipVersion++;
+    // порядок открытий не хранится — считаем по позиции в файле;
+    // активность тоже не хранится — с нуля
+    openSeqNow = 0;
+    memset(activity, 0, sizeof(activity));
+    for (uint16_t i = 0; i < count; ++i)
+      TouchOpen(i);
+    HashRebuild();
 
     // Restore gLastActiveLoot pointer
     if (gLastActiveLootIndex >= 0 && gLastActiveLootIndex < count) {
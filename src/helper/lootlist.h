@@ -7,15 +7,20 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#define LOOT_SIZE_MAX 50
+#define LOOT_SIZE_MAX 50 // по 16 байт с индексом и LRU
 
 int16_t LOOT_IndexOf(Loot *loot);
 void LOOT_BlacklistLast();
 void LOOT_WhitelistLast();
+void LOOT_ToggleBlacklist(Loot *item);
+void LOOT_ToggleWhitelist(Loot *item);
+// Меняется при любом изменении множества black/white (кэши пропусков)
+uint16_t LOOT_SkipVersion(void);
 Loot *LOOT_Get(uint32_t f);
 Loot *LOOT_AddEx(uint32_t f, bool reuse);
 Loot *LOOT_Add(uint32_t f);
 void LOOT_Remove(uint16_t i);
+uint16_t LOOT_SetFrequency(uint16_t i, uint32_t f); // новый индекс записи
 void LOOT_Clear();
 void LOOT_Standby();
 uint16_t LOOT_Size();
@@ -24,6 +29,10 @@ void LOOT_UpdateEx(Loot *loot, Measurement *msm);
 void LOOT_Update(Measurement *msm);
 void LOOT_Replace(Measurement *loot, uint32_t f);
 
+// Сколько открывался недавно (0 — тихий); гасится вдвое за каждый halvings
+uint8_t LOOT_Activity(const Loot *item);
+void LOOT_DecayActivity(uint8_t halvings);
+
 void LOOT_Sort(bool (*compare)(const Loot *a, const Loot *b), bool reverse);
 
 bool LOOT_SortByLastOpenTime(const Loot *a, const Loot *b);
@@ -0,0 +1,81 @@
+#include "persist.h"
+#include "../driver/systick.h"
+#include "../driver/uart.h"
+#include "../radio.h"
+#include "scan.h"
+
+#define PERSIST_MAX_DELAY_MS 10000 // правки подряд не откладывают запись вечно
+
+typedef struct {
+  PersistFn save;
+  uint32_t firstAt; // первая правка пачки
+  uint32_t dueAt;
+} PendingSave;
+
+static PendingSave pending[PERSIST_MAX];
+static uint8_t pendingCount;
+
+// Стирание держит цикл десятки миллисекунд — на передаче не пишем вовсе
+static bool TxActive(void) {
+  if (!gRadioState)
+    return false;
+  for (uint8_t i = 0; i < gRadioState->num_vfos; ++i) {
+    if (gRadioState->vfos[i].context.tx_state.is_active)
+      return true;
+  }
+  return false;
+}
+
+static void Run(uint8_t i) {
+  PersistFn save = pending[i].save;
+  pending[i] = pending[--pendingCount];
+  save();
+}
+
+void PERSIST_Mark(PersistFn save, uint16_t delayMs) {
+  uint32_t now = Now();
+  for (uint8_t i = 0; i < pendingCount; ++i) {
+    PendingSave *p = &pending[i];
+    if (p->save != save)
+      continue;
+    p->dueAt = now + delayMs;
+    if (p->dueAt - p->firstAt > PERSIST_MAX_DELAY_MS)
+      p->dueAt = p->firstAt + PERSIST_MAX_DELAY_MS;
+    return;
+  }
+  if (pendingCount == PERSIST_MAX) {
+    // очередь на все источники — сюда не попадаем; не теряем правку
+    Log("[PERSIST] queue full");
+    save();
+    return;
+  }
+  pending[pendingCount++] = (PendingSave){
+      .save = save, .firstAt = now, .dueAt = now + delayMs};
+}
+
+void PERSIST_Update(void) {
+  if (!pendingCount || TxActive())
+    return;
+  uint32_t now = Now();
+  // по одной записи за проход цикла — клавиатура и экран не ждут всех
+  for (uint8_t i = 0; i < pendingCount; ++i) {
+    if ((int32_t)(now - pending[i].dueAt) < 0)
+      continue;
+    // пишем только при закрытом шумодаве и без замеров: приём не
+    // прерывается, драйвер флеша на полной скорости. Сканер отдаёт окно в
+    // конце прохода
+    if (!SCAN_IsPersistAllowed()) {
+      SCAN_RequestQuiet();
+      return;
+    }
+    Run(i);
+    return;
+  }
+}
+
+void PERSIST_Flush(void) {
+  while (pendingCount)
+    Run(pendingCount - 1);
+}
+
+bool PERSIST_Pending(void) { return pendingCount != 0; }
@@ -0,0 +1,25 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Отложенная запись состояния (настройки, VFO, анализатор, раскладки,
+// пол диапазонов).
+// Источник отмечает изменение — запись одна на пачку правок, из главного
+// цикла и только при закрытом шумодаве, пока сканер не меряет
+// (SCAN_IsPersistAllowed). Во время передачи и приёма не пишем.
+// PERSIST_Flush пишет сразу — если сканер меряет, на медленной шине.
+
+#define PERSIST_MAX 5 // по источнику: настройки, VFO, анализатор, раскладки, пол
+
+typedef void (*PersistFn)(void);
+
+// Запись через delayMs после последней правки (не позже PERSIST_MAX_DELAY_MS
+// от первой)
+void PERSIST_Mark(PersistFn save, uint16_t delayMs);
+void PERSIST_Update(void);  // главный цикл
+void PERSIST_Flush(void);   // всё отложенное — сейчас (выход из приложения)
+bool PERSIST_Pending(void);
+
+#endif
@@ -1,18 +1,50 @@
 #include "scan.h"
 #include "../driver/bk4829.h"
+#include "../driver/hrtime.h"
 #include "../driver/systick.h"
 #include "../driver/uart.h"
 #include "../helper/lootlist.h"
 #include "../helper/scancommand.h"
+#include "../misc.h"
 #include "../radio.h"
+#include "../inc/channel.h"
 #include "../settings.h"
 #include "../ui/spectrum.h"
+#include "bandfloor.h"
 #include "bands.h"
 #include "measurements.h"
+#include "storage.h"
+#include "warmup.h"
+#include <string.h>
 
 #define GARBAGE_FREQ_STEP 650000U
 #define SOFT_SQ_HEADROOM 25 // % смягчения аппаратных порогов
 #define STE_DEBOUNCE_MS 250 // окно подавления STE-хвоста
+#define SKIP_MAP_STEPS 512 // 64 байта: 10 МГц по 25 кГц; шире — по-старому
+#define PLAN_SQL_NONE 0xFF
+#define PLAN_SQL_CACHE 4    // готовых слов шумодава: нужны только перед CHECKING
+#define CH_SCAN_MAX 32       // каналов в скане; по 10 байт
+#define CH_SCAN_CHUNK 4      // CH за одно чтение Channels.ch (112 байт стека)
+#define CHANNELS_FILE "Channels.ch"
+#define PRIO_MAX 4               // приоритетных частот
+#define PRIO_INTERVAL_MS 500     // до SCAN_SetPriorityInterval (настройка "Prio t")
+#define HOT_MAX 8                // активных частот с повторными заходами
+#define HOT_EVERY 8              // заход на столько шагов (+1/8 к циклу)
+#define HOT_MIN_ACTIVITY 32      // два открытия подряд без затухания
+#define HOT_DECAY_MS 30000       // активность loot гаснет вдвое
+
+// --- Двухпроходный скан (грубо -> точно) ---
+#define COARSE_SPAN 5000     // 50 kHz между грубыми точками (10 Hz)
+#define COARSE_MAX_FACTOR 8  // не реже 8 шагов
+#define COARSE_MARGIN 4      // 2 dB над полом грубого прохода
+#define COARSE_BW BK4819_FILTER_BW_26k
+
+// --- Поиск частотомером BK4819 (как apps/fc.c) ---
+#define HUNT_HZ 290         // порог счётчика, FC_HZ_LOW
+#define HUNT_HITS 2         // столько совпадающих отсчётов подряд
+#define HUNT_MATCH 300      // 3 kHz — тот же сигнал
+#define HUNT_POLL_MS 10     // опрос REG_0D после окна счёта
+#define HUNT_TIMEOUT_X 3    // окно счёта ×3 без результата — перезапуск
 
 // --- Адаптивный детектор (EMA) ---
 #define ADAP_MIN_SAMPLES 8   // прогрев
@@ -24,6 +56,16 @@
 #define FLOOR_MARGIN_NOISE 3 // запас под EMA noise
 #define FLOOR_MARGIN_GLITCH 3
 
+// --- Карта пола по точкам диапазона ---
+#define FLOOR_MAP_BINS 256 // по 4 бита — 128 байт; шагов больше — точки на бин
+#define FLOOR_MAP_UNIT 4    // ед. смещения: 2 dB (rssi в 0.5 dB)
+#define FLOOR_MAP_ZERO 8    // полубайт 8 — смещение 0, диапазон -8..+7
+
+// --- Статистический детектор ---
+#define STAT_K_DEFAULT 2
+#define STAT_MIN_SAMPLES 8
+#define STAT_MIN_MARGIN 4 // не ближе 2 dB к среднему — иначе ловим джиттер
+
 typedef struct {
   uint16_t rssiEma;   // значение << ADAP_EMA_SHIFT
   uint16_t noiseEma;
@@ -36,10 +78,26 @@ typedef struct {
 
 static AdaptiveFloor afloor;
 
+// Смещение пола точки от общего EMA: свои помехи, наводки, склоны фильтра
+typedef struct {
+  uint8_t nib[FLOOR_MAP_BINS / 2];
+  uint32_t startF; // ключ: карта от этого диапазона/списка
+  uint32_t endF;
+  uint32_t stepF;
+  uint32_t steps; // точек в диапазоне
+  uint16_t bins;
+  int16_t cur; // бин текущего замера, -1 — не по карте
+  bool channels;
+} FloorMap;
+
+static FloorMap fmap = {.cur = -1};
+
 static ScanContext scan = {
     .state = SCAN_STATE_IDLE,
     .mode = SCAN_MODE_SINGLE,
     .warmupUs = 2500,
+    .autoWarmup = true,
+    .noiseHist.k = STAT_K_DEFAULT,
     .checkDelayMs = SQL_DELAY,
     .isOpen = false,
     .cmdRangeActive = false,
@@ -48,14 +106,101 @@ static ScanContext scan = {
 
 static SCMD_Context cmdctx;
 static uint32_t sqReopenAt = 0;
-
-const char *SCAN_MODE_NAMES[] = {
+static bool cmdPaused;      // SCMD_PAUSE: ждём pauseUntil в IDLE
+static uint32_t pauseUntil;
+static bool quietWanted; // SCAN_RequestQuiet: в конце прохода постоять
+static bool parked;      // проход кончен, следующий — через цикл
+
+// Конвейер шага: пока PLL захватывает F(n), ищем F(n+1) (пропуски, loot)
+// и доделываем CPU-работу по F(n-1). Момент замера будит ядро прерыванием
+// TIM2 (HRTIME_ScheduleAt), без busy-wait и без опроса.
+typedef struct {
+  bool tuned;        // F(n) запрограммирована, ждём захвата
+  uint32_t tunedAt;  // HRTIME_Now() в момент перестройки
+  uint32_t warmup;   // warmup этого шага, тики
+  volatile bool due; // warmup истёк (ставится из прерывания TIM2)
+  bool nextReady;    // F(n+1) уже найдена
+  uint32_t nextF;
+  bool hasDeferred;  // замер F(n-1) ещё не отдан в спектр
+  Measurement deferred;
+} ScanPipe;
+
+static ScanPipe pipe;
+
+// Пропуски текущего диапазона: бит на шаг (black/white loot + мусорные
+// частоты). Перестраивается по смене диапазона или LOOT_SkipVersion()
+typedef struct {
+  uint32_t bits[SKIP_MAP_STEPS / 32];
+  uint32_t startF;
+  uint32_t endF;
+  uint16_t stepF;
+  uint16_t steps;
+  uint16_t lootVersion;
+  bool garbage; // gSettings.skipGarbageFrequencies на момент сборки
+  bool valid;
+} SkipMap;
+
+static SkipMap skip;
+
+// Грубый проход широким фильтром с шагом factor·step. Грубая точка выше
+// пола прошлого прохода — сразу точное окно ±factor/2 шагов вокруг неё
+// (пока сигнал ещё в эфире), потом грубый проход продолжается.
+// Окна идут через тот же конвейер: scan.startF/endF/stepF — текущий отрезок
+typedef struct {
+  bool enabled;  // SCAN_SetCoarse
+  bool active;   // диапазон подошёл, идёт двухпроходный цикл
+  bool fine;     // сейчас точное окно
+  bool hasFloor; // первый грубый проход только снимает пол
+  uint32_t bandStart;
+  uint32_t bandEnd;
+  uint16_t fineStep;
+  uint8_t factor;
+  uint8_t bw;      // полоса VFO, вернём на точном проходе
+  uint8_t floor;   // пол прошлого грубого прохода
+  uint8_t split;   // среднее прошлого прохода: ниже — в пол
+  uint16_t bins;   // грубых точек в проходе
+  uint16_t resume; // с какой грубой точки продолжить после окна
+  uint32_t fineEnd; // конец прошлого окна в этом проходе
+  // пол считается на лету — точки прохода не храним
+  uint32_t sum;
+  uint32_t lowSum; // точки не выше split
+  uint16_t lowN;
+} CoarseSweep;
+
+static CoarseSweep coarse;
+
+// Поиск частотомером: чип сам считает частоту сильнейшей несущей в полосе
+// фильтра, сканер прыгает прямо на неё (округлив до шага) и проверяет
+// обычным порядком. Счёт идёт в IDLE, конец точки — снова счёт
+typedef struct {
+  bool enabled;  // SCAN_SetHwHunt
+  bool active;   // диапазон подошёл
+  bool counting; // REG_32 включён, ждём отсчёт
+  uint32_t bandStart;
+  uint32_t bandEnd;
+  uint16_t step;
+  uint32_t countedAt; // Now() при запуске счёта
+  uint32_t pollAt;
+  uint32_t lastF;
+  uint8_t hits;
+} HwHunt;
+
+static HwHunt hunt;
+
+const char *const SCAN_MODE_NAMES[] = {
     [SCAN_MODE_NONE] = "None",         [SCAN_MODE_SINGLE] = "VFO",
     [SCAN_MODE_FREQUENCY] = "Scan",    [SCAN_MODE_CHANNEL] = "CH Scan",
     [SCAN_MODE_ANALYSER] = "Analyser", [SCAN_MODE_MULTIWATCH] = "MultiWatch",
 };
 
-const char *SCAN_STATE_NAMES[] = {
+const char *const SCAN_ALGO_NAMES[] = {
+    [SCAN_ALGO_ADAPTIVE] = "EMA",
+    [SCAN_ALGO_FULLRESET] = "EMA0",
+    [SCAN_ALGO_STATISTICAL] = "Stat",
+    [SCAN_ALGO_CALIBRATED] = "Cal",
+};
+
+const char *const SCAN_STATE_NAMES[] = {
     [SCAN_STATE_IDLE] = "Idle",
     [SCAN_STATE_TUNING] = "Tuning",
     [SCAN_STATE_CHECKING] = "Checking",
@@ -137,7 +282,63 @@ static void AdapFloor_UpdateEma(uint8_t rssi, uint8_t noise, uint8_t glitch) {
     afloor.count++;
 }
 
+static void FloorMap_Reset(void) {
+  memset(fmap.nib, FLOOR_MAP_ZERO * 0x11, sizeof(fmap.nib));
+  fmap.cur = -1;
+}
+
+static int8_t FloorMap_Get(int16_t bin) {
+  uint8_t b = fmap.nib[bin >> 1];
+  return (int8_t)((bin & 1 ? b >> 4 : b & 0x0F)) - FLOOR_MAP_ZERO;
+}
+
+static void FloorMap_Set(int16_t bin, int8_t off) {
+  if (off < -FLOOR_MAP_ZERO)
+    off = -FLOOR_MAP_ZERO;
+  if (off > FLOOR_MAP_ZERO - 1)
+    off = FLOOR_MAP_ZERO - 1;
+  uint8_t v = off + FLOOR_MAP_ZERO;
+  uint8_t *b = &fmap.nib[bin >> 1];
+  *b = bin & 1 ? (*b & 0x0F) | (v << 4) : (*b & 0xF0) | v;
+}
+
+// rssi текущего замера за вычетом смещения его точки
+static uint8_t FloorMap_Normalize(uint8_t rssi) {
+  if (fmap.cur < 0)
+    return rssi;
+  int16_t r = (int16_t)rssi - FloorMap_Get(fmap.cur) * FLOOR_MAP_UNIT;
+  return r < 0 ? 0 : r > 255 ? 255 : r;
+}
+
+// Во сколько единиц точка выше общего пола (со знаком, к нулю)
+static int8_t FloorMap_Target(uint8_t rssi) {
+  return ((int16_t)rssi - EmaGet(afloor.rssiEma)) / FLOOR_MAP_UNIT;
+}
+
+// Фон: смещение ползёт к замеру по единице за визит — разовый всплеск
+// карту не сдвигает, ушедшая помеха за несколько проходов забывается
+static void FloorMap_Track(uint8_t rssi) {
+  if (fmap.cur < 0 || afloor.count < ADAP_MIN_SAMPLES)
+    return;
+  int8_t off = FloorMap_Get(fmap.cur);
+  int8_t target = FloorMap_Target(rssi);
+  if (target > off)
+    FloorMap_Set(fmap.cur, off + 1);
+  else if (target < off)
+    FloorMap_Set(fmap.cur, off - 1);
+}
+
+// Ложный кандидат: точку поднимаем сразу до замера, иначе проверка
+// шумодава повторится на ней каждый проход
+static void FloorMap_Learn(uint8_t rssi) {
+  if (fmap.cur >= 0 && afloor.count >= ADAP_MIN_SAMPLES)
+    FloorMap_Set(fmap.cur, FloorMap_Target(rssi));
+}
+
 static bool AdaptiveSq_Check(uint8_t rssi, uint8_t noise, uint8_t glitch) {
+  uint8_t raw = rssi;
+  rssi = FloorMap_Normalize(rssi);
+
   // прогрев: набираем фон, пропускаем детекцию
   if (afloor.count < ADAP_MIN_SAMPLES) {
     AdapFloor_UpdateEma(rssi, noise, glitch);
@@ -168,12 +369,109 @@ static bool AdaptiveSq_Check(uint8_t rssi, uint8_t noise, uint8_t glitch) {
   bool candidate = above_floor || sharp_front;
 
   // EMA обновляем только фоном — кандидаты не загрязняют пол
-  if (!candidate)
+  if (!candidate) {
     AdapFloor_UpdateEma(rssi, noise, glitch);
+    FloorMap_Track(raw);
+  }
 
   return candidate;
 }
 
+// --- Статистика фона: mean + k·σ по скользящему окну ---
+
+static BandFloor bandFloor; // SCAN_ALGO_CALIBRATED
+static bool bandFloorValid;
+
+static void NoiseHist_Reset(void) {
+  NoiseHistory *h = &scan.noiseHist;
+  uint8_t k = h->k;
+  memset(h, 0, sizeof(*h));
+  h->k = k;
+}
+
+static void NoiseHist_Push(uint8_t v) {
+  NoiseHistory *h = &scan.noiseHist;
+  if (h->count == NOISE_HISTORY_SIZE) {
+    uint8_t old = h->values[h->idx];
+    h->sum -= old;
+    h->sum_sq -= (uint16_t)old * old;
+  } else {
+    h->count++;
+  }
+  h->values[h->idx] = v;
+  h->sum += v;
+  h->sum_sq += (uint16_t)v * v;
+  h->idx = (h->idx + 1) % NOISE_HISTORY_SIZE;
+
+  h->mean = h->sum / h->count;
+  uint32_t var = (h->sum_sq - (uint32_t)h->sum * h->sum / h->count) / h->count;
+  h->stddev = SQRT16(var);
+}
+
+static uint8_t StatThreshold(uint8_t mean, uint8_t stddev) {
+  uint16_t margin = (uint16_t)scan.noiseHist.k * stddev;
+  if (margin < STAT_MIN_MARGIN)
+    margin = STAT_MIN_MARGIN;
+  uint16_t thr = mean + margin;
+  return thr > UINT8_MAX ? UINT8_MAX : thr;
+}
+
+static uint8_t ClampRssi(uint16_t rssi) {
+  return rssi > UINT8_MAX ? UINT8_MAX : rssi;
+}
+
+static bool Statistical_Check(uint16_t rssi) {
+  NoiseHistory *h = &scan.noiseHist;
+  uint8_t r = ClampRssi(rssi);
+  if (h->count < STAT_MIN_SAMPLES) {
+    NoiseHist_Push(r);
+    return false;
+  }
+  scan.adaptiveThreshold = StatThreshold(h->mean, h->stddev);
+  bool candidate = r > scan.adaptiveThreshold;
+  // кандидат входит в окно срезанным по порогу: сигнал не раздувает фон,
+  // но поднявшийся пол окно всё-таки догонит
+  NoiseHist_Push(candidate ? scan.adaptiveThreshold : r);
+  return candidate;
+}
+
+// Пока пол диапазона не снят — работаем как STATISTICAL, по концу прохода
+// запоминаем окно (HandleEndOfRange)
+static bool Calibrated_Check(uint16_t rssi) {
+  if (!bandFloorValid)
+    return Statistical_Check(rssi);
+  scan.adaptiveThreshold = StatThreshold(bandFloor.mean, bandFloor.stddev);
+  return ClampRssi(rssi) > scan.adaptiveThreshold;
+}
+
+static void BandFloor_Learn(void) {
+  // окна двухпроходного скана, точки частотомера и каналы — не весь
+  // диапазон, пол по ним не снимаем
+  if (scan.algo != SCAN_ALGO_CALIBRATED || bandFloorValid || coarse.active ||
+      hunt.active || scan.mode == SCAN_MODE_CHANNEL ||
+      scan.noiseHist.count < STAT_MIN_SAMPLES)
+    return;
+  bandFloor = (BandFloor){
+      .start = scan.startF,
+      .end = scan.endF,
+      .mean = scan.noiseHist.mean,
+      .stddev = scan.noiseHist.stddev,
+  };
+  bandFloorValid = true;
+  BANDFLOOR_Set(&bandFloor);
+}
+
+static bool Detect(const Measurement *m) {
+  switch (scan.algo) {
+  case SCAN_ALGO_STATISTICAL:
+    return Statistical_Check(m->rssi);
+  case SCAN_ALGO_CALIBRATED:
+    return Calibrated_Check(m->rssi);
+  default:
+    return AdaptiveSq_Check(m->rssi, m->noise, m->glitch);
+  }
+}
+
 static bool IsSkippable(uint32_t f) {
   if (gSettings.skipGarbageFrequencies && (f % GARBAGE_FREQ_STEP == 0))
     return true;
@@ -181,7 +479,88 @@ static bool IsSkippable(uint32_t f) {
   return l && (l->blacklist || l->whitelist);
 }
 
+static void SkipMap_Set(uint32_t f) {
+  if (f < skip.startF || f > skip.endF)
+    return;
+  uint32_t d = f - skip.startF;
+  if (d % skip.stepF)
+    return;
+  d /= skip.stepF;
+  skip.bits[d / 32] |= 1u << (d % 32);
+}
+
+// O(loot + мусорных частот в диапазоне), а не O(шагов)
+static void SkipMap_Build(void) {
+  skip.startF = scan.startF;
+  skip.endF = scan.endF;
+  skip.stepF = scan.stepF;
+  skip.lootVersion = LOOT_SkipVersion();
+  skip.garbage = gSettings.skipGarbageFrequencies;
+  skip.valid = false;
+
+  if (!scan.stepF || scan.endF < scan.startF)
+    return;
+  uint32_t steps = (scan.endF - scan.startF) / scan.stepF + 1;
+  if (steps > SKIP_MAP_STEPS)
+    return;
+  skip.steps = steps;
+  memset(skip.bits, 0, (steps + 31) / 32 * sizeof(uint32_t));
+
+  for (uint16_t i = 0; i < LOOT_Size(); ++i) {
+    Loot *l = LOOT_Item(i);
+    if (l->blacklist || l->whitelist)
+      SkipMap_Set(l->f);
+  }
+  if (skip.garbage) {
+    uint32_t g = (scan.startF + GARBAGE_FREQ_STEP - 1) / GARBAGE_FREQ_STEP *
+                 GARBAGE_FREQ_STEP;
+    for (; g <= scan.endF; g += GARBAGE_FREQ_STEP)
+      SkipMap_Set(g);
+  }
+  skip.valid = true;
+}
+
+static bool SkipMap_Ready(void) {
+  if (skip.startF != scan.startF || skip.endF != scan.endF ||
+      skip.stepF != scan.stepF || skip.lootVersion != LOOT_SkipVersion() ||
+      skip.garbage != gSettings.skipGarbageFrequencies)
+    SkipMap_Build();
+  return skip.valid;
+}
+
+// Первый нулевой бит начиная с i (skip.steps — таких нет).
+// Целые слова пропусков перешагиваем за раз
+static uint32_t SkipMap_NextFree(uint32_t i) {
+  while (i < skip.steps) {
+    uint32_t free = ~skip.bits[i / 32] >> (i % 32);
+    if (free) {
+      i += __builtin_ctz(free);
+      break;
+    }
+    i = (i | 31) + 1;
+  }
+  return i < skip.steps ? i : skip.steps;
+}
+
+static void Pipe_Flush(void) {
+  if (pipe.hasDeferred) {
+    SP_AddPoint(&pipe.deferred);
+    pipe.hasDeferred = false;
+  }
+}
+
+// currentF сменили снаружи конвейера — предвыборка недействительна
+static void Pipe_Reset(void) {
+  Pipe_Flush();
+  HRTIME_Cancel();
+  pipe.tuned = false;
+  pipe.due = false;
+  pipe.nextReady = false;
+}
+
 static void ChangeState(ScanState s) {
+  if (s == SCAN_STATE_TUNING)
+    Pipe_Reset();
   if (scan.state != s) {
     scan.state = s;
     scan.stateEnteredAt = Now();
@@ -201,6 +580,9 @@ static void UpdateCPS(void) {
 }
 
 static void ApplyBandSettings(void) {
+  pipe.hasDeferred = false; // точка старого диапазона
+  Pipe_Reset();
+  NoiseHist_Reset(); // фон другого диапазона нам не нужен
   vfo->msm.f = gCurrentBand.start;
   RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, false, false);
   RADIO_SetParam(ctx, PARAM_FREQUENCY, vfo->msm.f, false);
@@ -219,21 +601,545 @@ static void AdapFloor_SoftReset(void) {
   afloor.prevGlitch = 0;
 }
 
+// ============================================================================
+// Каналы текущего скан-листа: из Channels.ch пачками в компактную таблицу,
+// по возрастанию частоты (меньше скачки PLL). Сканер идёт по ней тем же
+// конвейером: currentF — частота канала, следующий — первый выше
+// ============================================================================
+
+typedef struct {
+  uint32_t f : 27;
+  uint32_t modulation : 4;
+  uint16_t num; // номер в CHANNELS_FILE
+  uint8_t bw : 4;
+  Squelch squelch;
+  Code code;
+} __attribute__((packed)) ScanChannel;
+
+typedef struct {
+  ScanChannel ch[CH_SCAN_MAX];
+  uint16_t count;
+  uint16_t listed; // в скан-листе, вместе с не влезшими в CH_SCAN_MAX
+  uint16_t cur;    // канал currentF
+  bool active;  // SCAN_MODE_CHANNEL и список не пуст
+} ChannelList;
+
+static ChannelList chans;
+
+static bool Chan_InList(const CH *c, uint16_t scanlist) {
+  if (!IsReadable(c->name) || c->radio != RADIO_BK4819 || !c->rxF)
+    return false;
+  return !scanlist || (c->scanlists & scanlist); // 0 — все каналы
+}
+
+// Первый канал с частотой >= f (count — таких нет)
+static uint16_t Chan_Find(uint32_t f) {
+  uint16_t lo = 0, hi = chans.count;
+  while (lo < hi) {
+    uint16_t mid = (lo + hi) / 2;
+    if (chans.ch[mid].f < f)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static void Chan_Insert(const CH *c, uint16_t num) {
+  uint16_t i = Chan_Find(c->rxF);
+  if (i < chans.count && chans.ch[i].f == c->rxF)
+    return; // та же частота — слушаем первый канал
+  i = chans.count++;
+  for (; i && chans.ch[i - 1].f > c->rxF; --i)
+    chans.ch[i] = chans.ch[i - 1];
+  chans.ch[i] = (ScanChannel){
+      .f = c->rxF,
+      .modulation = c->modulation,
+      .num = num,
+      .bw = c->bw,
+      .squelch = c->squelch,
+      .code = c->code.rx,
+  };
+}
+
+static uint16_t Chan_Load(void) {
+  CH buf[CH_SCAN_CHUNK];
+  uint16_t total = Storage_Count(CHANNELS_FILE, sizeof(CH));
+  uint16_t scanlist = gSettings.currentScanlist;
+
+  chans.count = 0;
+  chans.listed = 0;
+  // файл дочитываем и после CH_SCAN_MAX: сколько не влезло, видно в UI
+  for (uint16_t base = 0; base < total; base += CH_SCAN_CHUNK) {
+    uint16_t n = total - base < CH_SCAN_CHUNK ? total - base : CH_SCAN_CHUNK;
+    if (!Storage_LoadMultiple(CHANNELS_FILE, base, buf, sizeof(CH), n))
+      break;
+    for (uint16_t i = 0; i < n; ++i) {
+      if (!Chan_InList(&buf[i], scanlist))
+        continue;
+      chans.listed++;
+      if (chans.count < CH_SCAN_MAX)
+        Chan_Insert(&buf[i], base + i);
+    }
+  }
+  Log("[SCAN] %u channels of %u listed, %u in file", chans.count, chans.listed,
+      total);
+  return chans.count;
+}
+
+// Настройки канала, которые меряет RSSI: модуляция и полоса. В чип их
+// пишет ApplySettings пакетом — неизменившиеся регистры отбрасываются
+static void Chan_Apply(const ScanChannel *c) {
+  if (ctx->modulation != c->modulation)
+    RADIO_SetParam(ctx, PARAM_MODULATION, c->modulation, false);
+  if (ctx->bandwidth != c->bw)
+    RADIO_SetParam(ctx, PARAM_BANDWIDTH, c->bw, false);
+  if (ctx->squelch.type != c->squelch.type)
+    RADIO_SetParam(ctx, PARAM_SQUELCH_TYPE, c->squelch.type, false);
+  // уровень — в мягкий порог; регистры шумодава из плана в Plan_Commit
+  ctx->squelch.value = c->squelch.value;
+}
+
+// ============================================================================
+// Активные частоты: loot текущего прохода, который чаще открывался,
+// навещается между шагами чаще тихого (HOT_EVERY). Веса — активность loot,
+// заходы делятся по весам плавным взвешенным кругом
+// ============================================================================
+
+typedef struct {
+  uint32_t f[HOT_MAX];
+  uint8_t weight[HOT_MAX];
+  int16_t credit[HOT_MAX];
+  uint8_t count;
+  uint8_t steps; // шагов прохода с прошлого захода
+  uint32_t pick; // частота текущего захода
+  uint32_t decayAt;
+} HotList;
+
+static HotList hot;
+
+static bool Hot_InRange(uint32_t f) {
+  if (f < scan.startF || f > scan.endF || IsSkippable(f))
+    return false;
+  if (chans.active) {
+    uint16_t i = Chan_Find(f);
+    return i < chans.count && chans.ch[i].f == f;
+  }
+  return !scan.stepF || (f - scan.startF) % scan.stepF == 0;
+}
+
+// В начале прохода: гасим активность и берём HOT_MAX самых живых
+static void Hot_Build(void) {
+  uint32_t halvings = (Now() - hot.decayAt) / HOT_DECAY_MS;
+  if (halvings) {
+    LOOT_DecayActivity(halvings > 8 ? 8 : halvings);
+    hot.decayAt += halvings * HOT_DECAY_MS;
+  }
+
+  hot.count = 0;
+  for (uint16_t i = 0; i < LOOT_Size(); ++i) {
+    Loot *l = LOOT_Item(i);
+    uint8_t w = LOOT_Activity(l);
+    if (w < HOT_MIN_ACTIVITY || !Hot_InRange(l->f))
+      continue;
+    // вставка по убыванию веса, лишний хвост отбрасывается
+    uint8_t k = hot.count < HOT_MAX ? hot.count++ : HOT_MAX;
+    for (; k && hot.weight[k - 1] < w; --k) {
+      if (k < HOT_MAX) {
+        hot.f[k] = hot.f[k - 1];
+        hot.weight[k] = hot.weight[k - 1];
+      }
+    }
+    if (k < HOT_MAX) {
+      hot.f[k] = l->f;
+      hot.weight[k] = w;
+    }
+  }
+  memset(hot.credit, 0, sizeof(hot.credit));
+}
+
+// Замер без кандидата: loot на этой частоте больше не открыт — следующее
+// открытие будет новой передачей (LOOT_Activity)
+static void Hot_MarkClosed(void) {
+  Loot *l = LOOT_Get(scan.measurement.f);
+  if (l && l->open) {
+    scan.measurement.open = false;
+    LOOT_UpdateEx(l, &scan.measurement);
+  }
+}
+
+static bool Hot_Due(void) {
+  if (!hot.count || ++hot.steps < HOT_EVERY)
+    return false;
+  hot.steps = 0;
+  return true;
+}
+
+// Плавный взвешенный круг: вес 2 — вдвое чаще веса 1, без серий подряд.
+// Идущую передачу уже слушали — её начало не ловим (0 — заходить некуда)
+static uint32_t Hot_Pick(void) {
+  uint16_t total = 0;
+  int8_t best = -1;
+  for (uint8_t i = 0; i < hot.count; ++i) {
+    Loot *l = LOOT_Get(hot.f[i]);
+    if (l && l->open)
+      continue;
+    hot.credit[i] += hot.weight[i];
+    total += hot.weight[i];
+    if (best < 0 || hot.credit[i] > hot.credit[best])
+      best = i;
+  }
+  if (best < 0)
+    return 0;
+  hot.credit[best] -= total;
+  return hot.f[best];
+}
+
+// ============================================================================
+// План перестроек: слова PLL и фильтр точки считаются прямо на шаге (это
+// пара сдвигов) и пишутся в чип напрямую — без RADIO_SetParam, поиска
+// диапазона и freqCorrection. Таблицы на весь отрезок нет: точка вне сетки
+// (SCAN_SetStartF, заход приоритета) получает свои слова, а не соседние.
+// Шумодав точки — готовые регистры, в чип только перед CHECKING
+// ============================================================================
+
+typedef struct {
+  BK4819_PlannedTune tune;
+  uint8_t sql; // PLAN_SQL(uhf, level)
+} PlanEntry;
+
+#define PLAN_SQL(uhf, level) ((uhf) * SQ_PRESETS_COUNT + (level))
+
+typedef struct {
+  PlanEntry e;       // точка текущего шага
+  uint8_t sqlDelays; // на чём собраны sqlWords
+  BK4819_SquelchWords sqlWords[PLAN_SQL_CACHE]; // ячейка sql % PLAN_SQL_CACHE
+  uint8_t sqlTag[PLAN_SQL_CACHE]; // sql + 1 в ячейке, 0 — пусто
+  uint8_t sqlApplied; // что сейчас в чипе
+} ScanPlan;
+
+static ScanPlan plan;
+
+static uint8_t Plan_SqlDelays(void) {
+  return gSettings.sqlOpenTime << 2 | gSettings.sqlCloseTime;
+}
+
+// NULL — шаг идёт через RADIO_SetParam
+static const PlanEntry *Plan_Get(uint32_t f) {
+  if (ctx->radio_type != RADIO_BK4819)
+    return NULL;
+  if (plan.sqlDelays != Plan_SqlDelays()) {
+    plan.sqlDelays = Plan_SqlDelays();
+    memset(plan.sqlTag, 0, sizeof(plan.sqlTag));
+    plan.sqlApplied = PLAN_SQL_NONE;
+  }
+  // у каналов уровень свой
+  uint8_t sqlLevel = chans.active && chans.cur < chans.count
+                         ? chans.ch[chans.cur].squelch.value
+                         : ctx->squelch.value;
+  // частота в чипе: и PLL, и VHF/UHF шумодава — как ctx->frequency в radio.c
+  uint32_t rf = f + ctx->upconverter;
+  BK4819_PlanTune(&plan.e.tune, rf, ctx->filter == FILTER_AUTO);
+  plan.e.sql = PLAN_SQL(rf >= SETTINGS_GetFilterBound(), sqlLevel);
+  return &plan.e;
+}
+
+// Перед CHECKING: шумодав точки и частота в VFO (для UI, loot, аудио).
+// Чип уже настроен — dirty по частоте снимаем
+static void Plan_Commit(uint32_t f) {
+  const PlanEntry *e = Plan_Get(f);
+  if (!e)
+    return;
+  if (e->sql != plan.sqlApplied) {
+    uint8_t uhf = e->sql >= SQ_PRESETS_COUNT;
+    uint8_t slot = e->sql % PLAN_SQL_CACHE;
+    if (plan.sqlTag[slot] != e->sql + 1) {
+      BK4819_PlanSquelch(&plan.sqlWords[slot], e->sql % SQ_PRESETS_COUNT,
+                         uhf ? SETTINGS_GetFilterBound() : 0,
+                         gSettings.sqlOpenTime, gSettings.sqlCloseTime);
+      plan.sqlTag[slot] = e->sql + 1;
+    }
+    BK4819_ApplySquelch(&plan.sqlWords[slot]);
+    plan.sqlApplied = e->sql;
+  }
+  bool wasDirty = ctx->dirty & PARAM_BIT(PARAM_FREQUENCY);
+  RADIO_SetParam(ctx, PARAM_FREQUENCY, f, false);
+  if (!wasDirty)
+    ctx->dirty &= ~PARAM_BIT(PARAM_FREQUENCY);
+
+  // субтон канала нужен только для прослушивания
+  if (chans.active) {
+    const ScanChannel *c = &chans.ch[chans.cur];
+    if (ctx->code.type != c->code.type || ctx->code.value != c->code.value) {
+      ctx->code = c->code;
+      ctx->dirty |= PARAM_BIT(PARAM_RX_CODE);
+      RADIO_ApplySettings(ctx);
+      plan.sqlApplied = PLAN_SQL_NONE;
+    }
+  }
+}
+
 static void BeginScanRange(uint32_t start, uint32_t end, uint16_t step) {
+  plan.sqlApplied = PLAN_SQL_NONE;
   scan.startF = start;
   scan.endF = end;
   scan.currentF = start;
   scan.stepF = step;
+  scan.calWarmupUs = WARMUP_ForRange(start, end, step);
+  Hot_Build();
+  if (!coarse.active) // окна берут пол всего диапазона (Coarse_Begin)
+    bandFloorValid = BANDFLOOR_Get(start, end, &bandFloor);
   scan.cmdRangeActive = true;
   AdapFloor_SoftReset();
   ChangeState(SCAN_STATE_TUNING);
 }
 
+// Скан по каналам: шаг 10 Hz — «следующий» это первый канал выше
+static bool Chan_Begin(void) {
+  chans.active = false;
+  if (!Chan_Load())
+    return false;
+  chans.active = true;
+  chans.cur = 0;
+  BeginScanRange(chans.ch[0].f, chans.ch[chans.count - 1].f, 1);
+  return true;
+}
+
+// ============================================================================
+
+static void Coarse_SetWide(bool wide) {
+  RADIO_SetParam(ctx, PARAM_BANDWIDTH, wide ? COARSE_BW : coarse.bw, false);
+}
+
+static void Coarse_Stop(void) {
+  if (coarse.active && !coarse.fine)
+    Coarse_SetWide(false);
+  coarse.active = false;
+}
+
+// центр грубой точки: bandStart + (bin·factor + factor/2) точных шагов
+static uint32_t Coarse_BinF(uint16_t bin) {
+  return coarse.bandStart +
+         ((uint32_t)bin * coarse.factor + coarse.factor / 2) * coarse.fineStep;
+}
+
+static void Coarse_ResumePass(uint16_t bin) {
+  coarse.fine = false;
+  Coarse_SetWide(true);
+  BeginScanRange(Coarse_BinF(bin), coarse.bandEnd,
+                 coarse.factor * coarse.fineStep);
+}
+
+static void Coarse_StartPass(void) {
+  coarse.bins = 0;
+  coarse.sum = 0;
+  coarse.lowSum = 0;
+  coarse.lowN = 0;
+  coarse.fineEnd = 0;
+  Coarse_ResumePass(0);
+}
+
+// Двухпроходный скан только там, где он что-то даёт
+static bool Coarse_Begin(uint32_t start, uint32_t end, uint16_t step) {
+  if (!coarse.enabled || scan.mode != SCAN_MODE_FREQUENCY || scan.cmdCtx ||
+      !step || end <= start)
+    return false;
+  uint8_t factor = COARSE_SPAN / step;
+  if (factor > COARSE_MAX_FACTOR)
+    factor = COARSE_MAX_FACTOR;
+  uint32_t bins = (end - start) / step / factor + 1;
+  if (factor < 2 || bins < 4)
+    return false;
+
+  if (!coarse.active)
+    coarse.bw = RADIO_GetParam(ctx, PARAM_BANDWIDTH);
+  coarse.active = true;
+  coarse.hasFloor = false;
+  coarse.bandStart = start;
+  coarse.bandEnd = end;
+  coarse.fineStep = step;
+  coarse.factor = factor;
+  bandFloorValid = BANDFLOOR_Get(start, end, &bandFloor);
+  Coarse_StartPass();
+  return true;
+}
+
+// false — окно целиком уже пройдено соседним (сигнал между грубыми точками
+// виден в обеих)
+static bool Coarse_EnterWindow(uint16_t bin) {
+  uint32_t half = coarse.factor / 2 * coarse.fineStep;
+  uint32_t center = Coarse_BinF(bin);
+  uint32_t start = center - half;
+  uint32_t end = center + half;
+  if (start < coarse.bandStart)
+    start = coarse.bandStart;
+  if (end > coarse.bandEnd)
+    end = coarse.bandEnd;
+  if (coarse.fineEnd && start <= coarse.fineEnd)
+    start = coarse.fineEnd + coarse.fineStep;
+  if (start > end)
+    return false;
+
+  coarse.resume = bin + 1;
+  coarse.fineEnd = end;
+  coarse.fine = true;
+  Coarse_SetWide(false);
+  BeginScanRange(start, end, coarse.fineStep);
+  return true;
+}
+
+// Замер грубой точки. true — точка над полом, ушли в точное окно
+static bool Coarse_Measured(const Measurement *m) {
+  uint16_t bin = (m->f - Coarse_BinF(0)) / (coarse.factor * coarse.fineStep);
+  uint8_t rssi = ClampRssi(m->rssi);
+  coarse.sum += rssi;
+  coarse.bins++;
+  // первый проход делит по среднему на ходу, дальше — по прошлому
+  uint8_t split = coarse.hasFloor ? coarse.split : coarse.sum / coarse.bins;
+  if (rssi <= split) {
+    coarse.lowSum += rssi;
+    coarse.lowN++;
+  }
+
+  if (!coarse.hasFloor || rssi <= coarse.floor + COARSE_MARGIN)
+    return false;
+  return Coarse_EnterWindow(bin);
+}
+
+// Пол прохода — среднее по точкам не выше среднего: сигналы его почти не
+// сдвигают
+static void Coarse_FinishPass(void) {
+  uint8_t mean = coarse.bins ? coarse.sum / coarse.bins : 0;
+  coarse.floor = coarse.lowN ? coarse.lowSum / coarse.lowN : mean;
+  coarse.split = mean;
+  coarse.hasFloor = coarse.bins != 0;
+}
+
+static void Coarse_EndOfRange(void) {
+  if (coarse.fine) {
+    Coarse_ResumePass(coarse.resume);
+    return;
+  }
+  Coarse_FinishPass();
+  scan.sweeps++;
+  SP_Begin();
+  Coarse_StartPass();
+}
+
+// ============================================================================
+// Поиск частотомером
+// ============================================================================
+
+static uint32_t Hunt_WindowMs(void) { return 200u << gSettings.fcTime; }
+
+static void Hunt_StartCount(void) {
+  // счётчику нужен живой приёмник на середине диапазона (фильтр, REG_51)
+  BK4819_SelectFilter(hunt.bandStart);
+  BK4819_SetScanFrequency(hunt.bandStart + (hunt.bandEnd - hunt.bandStart) / 2);
+  BK4819_EnableFrequencyScanEx2(gSettings.fcTime, HUNT_HZ);
+  hunt.counting = true;
+  hunt.countedAt = Now();
+  hunt.pollAt = hunt.countedAt + Hunt_WindowMs();
+  ChangeState(SCAN_STATE_IDLE);
+}
+
+static void Hunt_StopCount(void) {
+  if (!hunt.counting)
+    return;
+  BK4819_DisableFrequencyScan();
+  BK4819_RX_TurnOn();
+  hunt.counting = false;
+}
+
+static void Hunt_Stop(void) {
+  Hunt_StopCount();
+  hunt.active = false;
+}
+
+// Только частотный скан одного фильтра: счётчик не различает, откуда
+// несущая, — диапазон через границу VHF/UHF так не ищем
+static bool Hunt_Begin(uint32_t start, uint32_t end, uint16_t step) {
+  if (!hunt.enabled || scan.mode != SCAN_MODE_FREQUENCY || scan.cmdCtx ||
+      !step || end <= start)
+    return false;
+  uint32_t bound = SETTINGS_GetFilterBound();
+  if (start < bound && end >= bound)
+    return false;
+
+  Hunt_StopCount();
+  hunt.active = true;
+  hunt.bandStart = start;
+  hunt.bandEnd = end;
+  hunt.step = step;
+  hunt.hits = 0;
+  Hunt_StartCount();
+  return true;
+}
+
+// Отсчёт принят — проверяем частоту конвейером как диапазон из одной точки
+static void Hunt_Jump(uint32_t f) {
+  Hunt_StopCount();
+  hunt.hits = 0;
+  f = RoundToStep(f, hunt.step);
+  if (f < hunt.bandStart)
+    f = hunt.bandStart;
+  if (f > hunt.bandEnd)
+    f = hunt.bandEnd;
+  BeginScanRange(f, f, hunt.step);
+}
+
+static void Hunt_Poll(void) {
+  if ((int32_t)(Now() - hunt.pollAt) < 0)
+    return;
+  hunt.pollAt = Now() + HUNT_POLL_MS;
+
+  uint32_t f;
+  if (!BK4819_GetFrequencyScanResult(&f)) {
+    if (Now() - hunt.countedAt >= Hunt_WindowMs() * HUNT_TIMEOUT_X) {
+      Hunt_StopCount();
+      Hunt_StartCount();
+    }
+    return;
+  }
+
+  // вне диапазона — шум или чужая станция за фильтром
+  if (f < hunt.bandStart || f > hunt.bandEnd) {
+    hunt.hits = 0;
+  } else {
+    hunt.hits = DeltaF(f, hunt.lastF) < HUNT_MATCH ? hunt.hits + 1 : 1;
+    hunt.lastF = f;
+  }
+  if (hunt.hits >= HUNT_HITS) {
+    Hunt_Jump(f);
+    return;
+  }
+  // новый отсчёт — только после перезапуска счёта
+  Hunt_StopCount();
+  Hunt_StartCount();
+}
+
+static void Hunt_EndOfRange(void) {
+  SP_Begin();
+  Hunt_StartCount();
+}
+
+static void BeginSweep(uint32_t start, uint32_t end, uint16_t step) {
+  if (Hunt_Begin(start, end, step)) {
+    Coarse_Stop();
+    return;
+  }
+  Hunt_Stop();
+  if (Coarse_Begin(start, end, step))
+    return;
+  Coarse_Stop();
+  BeginScanRange(start, end, step);
+}
+
 static void UpdateBandAndRestart(void) {
   ApplyBandSettings();
   if (scan.mode == SCAN_MODE_FREQUENCY || scan.mode == SCAN_MODE_ANALYSER)
-    BeginScanRange(gCurrentBand.start, gCurrentBand.end,
-                   StepFrequencyTable[gCurrentBand.step]);
+    BeginSweep(gCurrentBand.start, gCurrentBand.end,
+               StepFrequencyTable[gCurrentBand.step]);
 }
 
 // ============================================================================
@@ -250,74 +1156,289 @@ static void ApplyCommand(SCMD_Command *cmd) {
     BeginScanRange(cmd->start, cmd->end, cmd->step);
     return;
   case SCMD_PAUSE:
-    SYSTICK_DelayMs(cmd->dwell_ms); // TODO: неблокирующая задержка
-    break;
+    // ждём в IDLE, главный цикл при этом живёт
+    pauseUntil = Now() + cmd->dwell_ms;
+    cmdPaused = true;
+    return;
   default:
     break;
   }
-  // MARKER, PAUSE (fall-through), JUMP, прочие — просто переходим дальше
+  // MARKER, JUMP, прочие — просто переходим дальше
   if (!SCMD_Advance(scan.cmdCtx))
     SCMD_Rewind(scan.cmdCtx);
 }
 
 static void HandleEndOfRange(void) {
+  Pipe_Flush(); // последняя точка — до SP_Begin
+  BandFloor_Learn();
   if (scan.cmdCtx) {
     if (!SCMD_Advance(scan.cmdCtx))
       SCMD_Rewind(scan.cmdCtx);
     scan.cmdRangeActive = false;
     ChangeState(SCAN_STATE_IDLE);
+  } else if (hunt.active) {
+    Hunt_EndOfRange();
+  } else if (coarse.active) {
+    Coarse_EndOfRange();
   } else {
+    scan.sweeps++;
     scan.currentF = scan.startF;
-    AdapFloor_SoftReset();
+    Hot_Build();
+    if (scan.algo == SCAN_ALGO_FULLRESET)
+      AdapFloor_Reset();
+    else
+      AdapFloor_SoftReset();
     ChangeState(SCAN_STATE_TUNING);
     SP_Begin();
   }
+  // между проходами ничего не настроено и VCO погашен — окно для флеша
+  if (quietWanted && !scan.cmdCtx && !hunt.active) {
+    quietWanted = false;
+    parked = true;
+  }
   gRedrawScreen = true;
 }
 
 // ============================================================================
 
 static void HandleStateIdle(void) {
+  if (hunt.counting) {
+    Hunt_Poll();
+    return;
+  }
   if (!scan.cmdCtx || scan.cmdRangeActive)
     return;
+  if (cmdPaused) {
+    if ((int32_t)(Now() - pauseUntil) < 0)
+      return;
+    cmdPaused = false;
+    if (!SCMD_Advance(scan.cmdCtx))
+      SCMD_Rewind(scan.cmdCtx);
+    return;
+  }
   SCMD_Command *cmd = SCMD_GetCurrent(scan.cmdCtx);
   if (cmd)
     ApplyCommand(cmd);
 }
 
-static void HandleStateTuning(void) {
-  if (scan.stepF == 0) {
-    if (IsSkippable(scan.currentF)) {
-      HandleEndOfRange();
-      return;
+// ============================================================================
+// Внеочередные заходы: посреди прохода (диапазон или каналы) конвейер уходит
+// на приоритетные частоты (раз в intervalMs) и на активные (Hot_Due), замер
+// сверяется с порогами шумодава и, если пусто, проход продолжается с той же
+// точки. Кандидат — обычная проверка железом и прослушивание
+// ============================================================================
+
+typedef struct {
+  uint32_t f[PRIO_MAX];
+  uint8_t count;
+  const uint32_t *list; // обходим: prio.f или &hot.pick
+  uint8_t listCount;
+  uint8_t idx;       // текущая в обходе
+  bool visiting;     // currentF — вне прохода
+  uint16_t intervalMs;
+  uint32_t lastAt;   // начало последнего обхода приоритетных
+  uint32_t resumeF;  // точка прохода: дальше с resumeF + stepF
+} PriorityWatch;
+
+static PriorityWatch prio = {.intervalMs = PRIO_INTERVAL_MS};
+
+static bool Visit_Allowed(void) {
+  // окна грубого прохода, частотомер и команды переставляют диапазон сами
+  return !prio.visiting &&
+         (scan.mode == SCAN_MODE_FREQUENCY || scan.mode == SCAN_MODE_CHANNEL) &&
+         !scan.cmdCtx && !coarse.active && !hunt.active;
+}
+
+static bool Prio_Due(void) {
+  return prio.count && prio.intervalMs && Visit_Allowed() &&
+         Now() - prio.lastAt >= prio.intervalMs;
+}
+
+// Первая непропускаемая частота начиная с f (> endF — диапазон кончился)
+static uint32_t FindNextF(uint32_t f) {
+  if (chans.active) {
+    for (uint16_t i = Chan_Find(f); i < chans.count; ++i) {
+      if (!IsSkippable(chans.ch[i].f))
+        return chans.ch[i].f;
+    }
+    return scan.endF + 1;
+  }
+  if (scan.stepF == 0)
+    return IsSkippable(f) ? scan.endF + 1 : f;
+  if (f >= scan.startF && SkipMap_Ready()) {
+    uint32_t i =
+        SkipMap_NextFree((f - scan.startF + scan.stepF - 1) / scan.stepF);
+    return scan.startF + i * scan.stepF;
+  }
+  while (f <= scan.endF && IsSkippable(f))
+    f += scan.stepF;
+  return f;
+}
+
+// Из прерывания TIM2: только флаг, шину BK4819 трогает главный цикл
+static void Pipe_OnWarmup(void) { pipe.due = true; }
+
+// Калибровка снята для шага на соседнюю частоту. Начало диапазона, пропуски
+// и одиночная частота — это другой скачок PLL, там ручной warmup
+static uint32_t WarmupUs(bool adjacent) {
+  if (adjacent && scan.autoWarmup && scan.calWarmupUs)
+    return scan.calWarmupUs;
+  return scan.warmupUs;
+}
+
+static void Pipe_Tune(bool adjacent) {
+  RADIO_MuteAudioNow(gRadioState);
+
+  if (chans.active && !prio.visiting) {
+    chans.cur = Chan_Find(scan.currentF);
+    Chan_Apply(&chans.ch[chans.cur]);
+  }
+
+  // приоритетная частота — вне плана
+  const PlanEntry *e = prio.visiting ? NULL : Plan_Get(scan.currentF);
+  if (e) {
+    // отложенное (полоса грубого прохода, настройки канала) — обычным путём
+    if (ctx->dirty) {
+      RADIO_ApplySettings(ctx);
+      plan.sqlApplied = PLAN_SQL_NONE;
     }
+    BK4819_TunePlanned(&e->tune); // VCO включается той же записью
+    // частота для UI; диапазон и поправки VFO — в Plan_Commit
+    ctx->frequency = scan.currentF + ctx->upconverter;
   } else {
-    while (scan.currentF <= scan.endF && IsSkippable(scan.currentF))
-      scan.currentF += scan.stepF;
+    // включаем VCO перед перестройкой (мог быть выключен после прошлого замера)
+    uint16_t reg30 = BK4819_ReadRegister(BK4819_REG_30);
+    if (!(reg30 & BK4819_REG_30_ENABLE_PLL_VCO))
+      BK4819_WriteRegister(BK4819_REG_30, reg30 | BK4819_REG_30_ENABLE_PLL_VCO);
+
+    RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, false, false);
+    RADIO_SetParam(ctx, PARAM_FREQUENCY, scan.currentF, false);
+    RADIO_ApplySettings(ctx);
+  }
+
+  pipe.tunedAt = HRTIME_Now();
+  pipe.warmup = HRTIME_UsToTicks(WarmupUs(adjacent));
+  pipe.tuned = true;
+  pipe.due = false;
+  HRTIME_ScheduleAt(pipe.tunedAt + pipe.warmup, Pipe_OnWarmup);
+}
+
+// Внеочередной заход, если подошло время: сперва приоритетные, потом
+// активная. resumeF — точка, после которой проход продолжится
+static bool Prio_Visit(uint32_t resumeF) {
+  if (Prio_Due()) {
+    prio.lastAt = Now();
+    prio.list = prio.f;
+    prio.listCount = prio.count;
+  } else if (Visit_Allowed() && Hot_Due()) {
+    hot.pick = Hot_Pick();
+    // только что её прошли или идём к ней — заход не нужен
+    if (!hot.pick || hot.pick == resumeF || hot.pick == resumeF + scan.stepF)
+      return false;
+    prio.list = &hot.pick;
+    prio.listCount = 1;
+  } else {
+    return false;
   }
+  prio.resumeF = resumeF;
+  prio.idx = 0;
+  prio.visiting = true;
+  scan.currentF = prio.list[0];
+  ChangeState(SCAN_STATE_TUNING);
+  Pipe_Tune(false);
+  return true;
+}
+
+// Следующая частота обхода или назад в проход
+static void Prio_Next(void) {
+  ChangeState(SCAN_STATE_TUNING);
+  if (++prio.idx < prio.listCount) {
+    scan.currentF = prio.list[prio.idx];
+    Pipe_Tune(false);
+    return;
+  }
+  prio.visiting = false;
+  scan.currentF = prio.resumeF + scan.stepF;
+}
+
+// Переход к следующему шагу и сразу перестройка — захват PLL идёт,
+// пока мы возвращаемся в главный цикл
+static void Pipe_Advance(void) {
+  if (Prio_Visit(scan.currentF))
+    return;
+  if (scan.stepF == 0) {
+    Pipe_Tune(false); // одиночная частота — снова её же
+    return;
+  }
+  uint32_t prevF = scan.currentF;
+  scan.currentF =
+      pipe.nextReady ? pipe.nextF : FindNextF(scan.currentF + scan.stepF);
+  pipe.nextReady = false;
 
   if (scan.currentF > scan.endF) {
     HandleEndOfRange();
     return;
   }
+  Pipe_Tune(scan.currentF - prevF == scan.stepF);
+}
 
-  RADIO_MuteAudioNow(gRadioState);
+// CPU-работа в окне захвата
+static void Pipe_IdleWork(void) {
+  Pipe_Flush();
+  if (!pipe.nextReady && scan.stepF && !prio.visiting) {
+    pipe.nextF = FindNextF(scan.currentF + scan.stepF);
+    pipe.nextReady = true;
+  }
+  UpdateCPS();
+}
 
-  // включаем VCO перед перестройкой (мог быть выключен после прошлого замера)
-  uint16_t reg30 = BK4819_ReadRegister(BK4819_REG_30);
-  if (!(reg30 & BK4819_REG_30_ENABLE_PLL_VCO))
-    BK4819_WriteRegister(BK4819_REG_30, reg30 | BK4819_REG_30_ENABLE_PLL_VCO);
+// Бин карты пола для currentF; чужой диапазон или список — карта заново
+static int16_t FloorMap_Locate(void) {
+  if (!scan.stepF)
+    return -1;
+  uint32_t steps = chans.active ? chans.count
+                                : (scan.endF - scan.startF) / scan.stepF + 1;
+  if (fmap.startF != scan.startF || fmap.endF != scan.endF ||
+      fmap.stepF != scan.stepF || fmap.channels != chans.active ||
+      fmap.steps != steps) {
+    FloorMap_Reset();
+    fmap.startF = scan.startF;
+    fmap.endF = scan.endF;
+    fmap.stepF = scan.stepF;
+    fmap.channels = chans.active;
+    fmap.steps = steps;
+    fmap.bins = steps < FLOOR_MAP_BINS ? steps : FLOOR_MAP_BINS;
+  }
+  uint32_t idx =
+      chans.active ? chans.cur : (scan.currentF - scan.startF) / scan.stepF;
+  if (idx >= steps)
+    return -1;
+  return (uint64_t)idx * fmap.bins / steps;
+}
 
-  RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, false, false);
-  RADIO_SetParam(ctx, PARAM_FREQUENCY, scan.currentF, false);
-  RADIO_ApplySettings(ctx);
+static void HandleStateTuning(void) {
+  if (!pipe.tuned) {
+    // после проверки currentF уже сдвинут на шаг
+    if (Prio_Visit(scan.currentF - scan.stepF))
+      return;
+    scan.currentF = FindNextF(scan.currentF);
+    if (scan.currentF > scan.endF) {
+      HandleEndOfRange();
+      return;
+    }
+    Pipe_Tune(false);
+    return;
+  }
 
-  SYSTICK_DelayUs(scan.warmupUs);
+  // due — штатный путь; проверка по счётчику страхует от потерянного IRQ
+  if (!pipe.due && !HRTIME_Elapsed(pipe.tunedAt, pipe.warmup)) {
+    Pipe_IdleWork();
+    return;
+  }
 
-  scan.measurement.rssi = RADIO_GetRSSI(ctx);
-  scan.measurement.noise = BK4819_GetNoise();
-  scan.measurement.glitch = BK4819_GetGlitch();
+  BK4819_ReadMeasurementBurst(&scan.measurement, false);
   scan.measurement.f = scan.currentF;
+  pipe.tuned = false;
 
   // глушим VCO сразу после замера — RSSI-детектор видит тишину, размазывания нет
   BK4819_WriteRegister(BK4819_REG_30,
@@ -325,25 +1446,62 @@ static void HandleStateTuning(void) {
                            ~BK4819_REG_30_ENABLE_PLL_VCO);
 
   scan.scanCycles++;
-  UpdateCPS();
+
+  // приоритетная: пол прохода по ней не трогаем, мерило — пороги шумодава
+  if (prio.visiting) {
+    if (SoftSq_Check(scan.measurement.rssi, scan.measurement.noise,
+                     scan.measurement.glitch)) {
+      BK4819_WriteRegister(BK4819_REG_30,
+                           BK4819_ReadRegister(BK4819_REG_30) |
+                               BK4819_REG_30_ENABLE_PLL_VCO);
+      // шумодав — по пресету самой приоритетной, не точки прохода
+      ctx->dirty |= PARAM_BIT(PARAM_SQUELCH_VALUE);
+      RADIO_ApplySettings(ctx);
+      plan.sqlApplied = PLAN_SQL_NONE;
+      ChangeState(SCAN_STATE_CHECKING);
+    } else {
+      Hot_MarkClosed();
+      Prio_Next();
+    }
+    return;
+  }
+
+  if (coarse.active && !coarse.fine) {
+    if (!Coarse_Measured(&scan.measurement))
+      Pipe_Advance();
+    return;
+  }
 
   if (scan.mode == SCAN_MODE_ANALYSER) {
-    SP_AddPoint(&scan.measurement);
-    scan.currentF += scan.stepF;
+    Pipe_Flush();
+    pipe.deferred = scan.measurement;
+    pipe.hasDeferred = true;
+    Pipe_Advance();
     return;
   }
 
-  if (AdaptiveSq_Check(scan.measurement.rssi, scan.measurement.noise,
-                       scan.measurement.glitch)) {
+  fmap.cur = hunt.active || coarse.active ? -1 : FloorMap_Locate();
+
+  // в точных окнах соседи сигнала есть всегда — адаптивный пол по ним
+  // задирается, поэтому меряем от пола грубого прохода
+  // частоту нашёл счётчик — сразу шумодав, пола по одной точке нет
+  bool candidate =
+      hunt.active ? true
+      : coarse.active
+          ? ClampRssi(scan.measurement.rssi) > coarse.floor + FLOOR_MARGIN_RSSI
+          : Detect(&scan.measurement);
+  if (candidate) {
     // включаем VCO обратно — CHECKING нужен живой приёмник для аппаратного шумодава
     BK4819_WriteRegister(BK4819_REG_30,
                          BK4819_ReadRegister(BK4819_REG_30) |
                              BK4819_REG_30_ENABLE_PLL_VCO);
+    Plan_Commit(scan.currentF);
+    UpdateCPS();
     ChangeState(SCAN_STATE_CHECKING);
   } else {
+    Hot_MarkClosed();
     scan.measurement.open = false;
-    scan.currentF += scan.stepF;
-    // VCO остаётся выключен — нет размазывания на следующий шаг
+    Pipe_Advance();
   }
 }
 
@@ -370,9 +1528,15 @@ static void HandleStateChecking(void) {
 
     ChangeState(SCAN_STATE_LISTENING);
   } else {
-    // ложный кандидат — скормить в EMA, чтобы пол адаптировался к размазыванию
-    AdapFloor_UpdateEma(scan.measurement.rssi, scan.measurement.noise,
-                        scan.measurement.glitch);
+    if (prio.visiting) {
+      Prio_Next();
+      return;
+    }
+    // ложный кандидат — точку поднять на карте, в EMA — уже с поправкой,
+    // чтобы общий пол адаптировался к размазыванию, а не к помехе
+    FloorMap_Learn(scan.measurement.rssi);
+    AdapFloor_UpdateEma(FloorMap_Normalize(scan.measurement.rssi),
+                        scan.measurement.noise, scan.measurement.glitch);
     scan.currentF += scan.stepF;
     ChangeState(SCAN_STATE_TUNING);
   }
@@ -402,7 +1566,10 @@ static void HandleStateListening(void) {
   }
 
   bool shouldLeave;
-  if (scan.isOpen) {
+  if (Prio_Due()) {
+    // приоритетная важнее: прослушивание обрывается, как по таймауту
+    shouldLeave = true;
+  } else if (scan.isOpen) {
     // открыт: уходим по общему таймауту пребывания
     shouldLeave = ElapsedMs() >= SCAN_TIMEOUTS[gSettings.sqOpenedTimeout];
   } else {
@@ -413,9 +1580,18 @@ static void HandleStateListening(void) {
 
   if (shouldLeave) {
     RADIO_MuteAudioNow(gRadioState);
-    scan.currentF += scan.stepF;
     sqClosedAt = 0;
-    ChangeState(SCAN_STATE_TUNING);
+    if (!scan.isOpen) {
+      // передача кончилась — в loot тоже
+      scan.measurement.open = false;
+      LOOT_Update(&scan.measurement);
+    }
+    if (prio.visiting) {
+      Prio_Next();
+    } else {
+      scan.currentF += scan.stepF;
+      ChangeState(SCAN_STATE_TUNING);
+    }
     gRedrawScreen = true;
   }
 }
@@ -437,7 +1613,6 @@ static void HandleModeSingle(void) {
 // ============================================================================
 
 void SCAN_Check(void) {
-  RADIO_CheckAndSaveVFO(gRadioState);
   if (scan.mode == SCAN_MODE_NONE)
     return;
 
@@ -450,6 +1625,11 @@ void SCAN_Check(void) {
     return;
   }
 
+  if (parked) {
+    parked = false;
+    return;
+  }
+
   switch (scan.state) {
   case SCAN_STATE_IDLE:
     HandleStateIdle();
@@ -472,8 +1652,14 @@ void SCAN_SetMode(ScanMode mode) {
   if (scan.cmdCtx && mode != scan.mode)
     SCAN_SetCommandMode(false);
 
+  Coarse_Stop();
+  Hunt_Stop();
+  quietWanted = false;
+  parked = false;
   scan.mode = mode;
   scan.scanCycles = 0;
+  chans.active = false;
+  prio.visiting = false;
   ChangeState(SCAN_STATE_IDLE);
 
   switch (mode) {
@@ -484,8 +1670,12 @@ void SCAN_SetMode(ScanMode mode) {
   case SCAN_MODE_FREQUENCY:
   case SCAN_MODE_ANALYSER:
     ApplyBandSettings();
-    BeginScanRange(gCurrentBand.start, gCurrentBand.end,
-                   StepFrequencyTable[gCurrentBand.step]);
+    BeginSweep(gCurrentBand.start, gCurrentBand.end,
+               StepFrequencyTable[gCurrentBand.step]);
+    break;
+  case SCAN_MODE_CHANNEL:
+    if (!Chan_Begin())
+      Log("[SCAN] no channels in scanlist %u", gSettings.currentScanlist);
     break;
   default:
     break;
@@ -494,12 +1684,70 @@ void SCAN_SetMode(ScanMode mode) {
 
 ScanMode SCAN_GetMode(void) { return scan.mode; }
 
+void SCAN_ClearPriority(void) {
+  prio.count = 0;
+  prio.visiting = false;
+}
+
+bool SCAN_AddPriority(uint32_t f) {
+  for (uint8_t i = 0; i < prio.count; ++i) {
+    if (prio.f[i] == f)
+      return true;
+  }
+  if (prio.count >= PRIO_MAX)
+    return false;
+  prio.f[prio.count++] = f;
+  return true;
+}
+
+bool SCAN_RemovePriority(uint32_t f) {
+  for (uint8_t i = 0; i < prio.count; ++i) {
+    if (prio.f[i] != f)
+      continue;
+    prio.f[i] = prio.f[--prio.count];
+    // идёт обход списка — не заходить за новый конец
+    if (prio.list == prio.f && prio.listCount > prio.count)
+      prio.listCount = prio.count;
+    return true;
+  }
+  return false;
+}
+
+bool SCAN_IsPriority(uint32_t f) {
+  for (uint8_t i = 0; i < prio.count; ++i) {
+    if (prio.f[i] == f)
+      return true;
+  }
+  return false;
+}
+
+uint8_t SCAN_GetPriorityCount(void) { return prio.count; }
+
+void SCAN_SetPriorityInterval(uint16_t ms) { prio.intervalMs = ms; }
+
+bool SCAN_IsPriorityVisit(void) {
+  return prio.visiting && prio.list == prio.f;
+}
+
+uint8_t SCAN_GetHotCount(void) { return hot.count; }
+
+uint16_t SCAN_GetChannelCount(void) { return chans.active ? chans.count : 0; }
+uint16_t SCAN_GetChannelListed(void) {
+  return chans.active ? chans.listed : 0;
+}
+
+int16_t SCAN_GetChannel(void) {
+  return chans.active && chans.cur < chans.count ? chans.ch[chans.cur].num
+                                                 : -1;
+}
+
 void SCAN_Init(void) {
   scan.lastCpsTime = Now();
   scan.scanCycles = 0;
   scan.currentCps = 0;
   scan.radioTimer = Now();
   AdapFloor_Reset();
+  NoiseHist_Reset();
 
   ApplyBandSettings();
   vfo->is_open = false;
@@ -543,16 +1791,95 @@ void SCAN_NextWhitelist(void) {
   SCAN_Next();
 }
 
-void SCAN_SetDelay(uint32_t delay) { scan.warmupUs = delay; }
-uint32_t SCAN_GetDelay(void) { return scan.warmupUs; }
+// Ручная установка выключает авто-warmup
+void SCAN_SetDelay(uint32_t delay) {
+  scan.warmupUs = delay;
+  scan.autoWarmup = false;
+}
+
+uint32_t SCAN_GetDelay(void) { return WarmupUs(true); }
+
+void SCAN_SetAutoDelay(bool enabled) { scan.autoWarmup = enabled; }
+bool SCAN_IsAutoDelay(void) { return scan.autoWarmup && scan.calWarmupUs; }
+
+void SCAN_SetCoarse(bool enabled) {
+  coarse.enabled = enabled;
+  UpdateBandAndRestart();
+}
+
+bool SCAN_IsCoarse(void) { return coarse.enabled; }
+
+void SCAN_SetHwHunt(bool enabled) {
+  hunt.enabled = enabled;
+  UpdateBandAndRestart();
+}
+
+bool SCAN_IsHwHunt(void) { return hunt.enabled; }
+uint32_t SCAN_GetSweeps(void) { return scan.sweeps; }
+
+void SCAN_SetAlgo(ScanAlgo algo) {
+  if (algo >= SCAN_ALGO_COUNT)
+    algo = SCAN_ALGO_ADAPTIVE;
+  scan.algo = algo;
+  AdapFloor_Reset();
+  NoiseHist_Reset();
+  scan.adaptiveThreshold = 0;
+}
+
+ScanAlgo SCAN_GetAlgo(void) { return scan.algo; }
+
+void SCAN_ForgetFloor(void) {
+  BANDFLOOR_Forget(scan.startF, scan.endF);
+  bandFloorValid = false;
+  FloorMap_Reset();
+  NoiseHist_Reset();
+}
+
+bool SCAN_CalibrateDelay(void) {
+  if (scan.mode != SCAN_MODE_FREQUENCY && scan.mode != SCAN_MODE_ANALYSER)
+    return false;
+  uint16_t us =
+      WARMUP_Calibrate(gCurrentBand.start, gCurrentBand.end, gCurrentBand.step);
+  scan.autoWarmup = true;
+  UpdateBandAndRestart();
+  return us != 0;
+}
 uint32_t SCAN_GetCps(void) { return scan.currentCps; }
 
+bool SCAN_IsSampleDue(void) {
+  return scan.state == SCAN_STATE_TUNING && pipe.tuned && pipe.due;
+}
+
+bool SCAN_IsRfQuiet(void) {
+  // в VFO RSSI идёт только на S-метр, детектор не работает
+  if (scan.mode == SCAN_MODE_NONE || scan.mode == SCAN_MODE_SINGLE)
+    return true;
+  if (parked || scan.state == SCAN_STATE_LISTENING)
+    return true;
+  return scan.state == SCAN_STATE_IDLE && !hunt.counting;
+}
+
+bool SCAN_IsPersistAllowed(void) {
+  // идёт приём — запись подождёт: флеш не должен рвать звук и S-метр
+  if (vfo->is_open)
+    return false;
+  if (scan.mode == SCAN_MODE_NONE || scan.mode == SCAN_MODE_SINGLE)
+    return true;
+  if (scan.isOpen || scan.state == SCAN_STATE_LISTENING)
+    return false;
+  return parked || (scan.state == SCAN_STATE_IDLE && !hunt.counting);
+}
+
+void SCAN_RequestQuiet(void) { quietWanted = true; }
+
 // ============================================================================
 
 void SCAN_LoadCommandFile(const char *filename) {
   if (scan.cmdCtx)
     SCAN_SetCommandMode(false);
 
+  Coarse_Stop();
+  Hunt_Stop();
   scan.cmdCtx = &cmdctx;
 
   if (SCMD_Init(scan.cmdCtx, filename)) {
@@ -566,6 +1893,7 @@ void SCAN_LoadCommandFile(const char *filename) {
 }
 
 void SCAN_SetCommandMode(bool enabled) {
+  cmdPaused = false;
   if (!enabled && scan.cmdCtx) {
     SCMD_Close(scan.cmdCtx);
     scan.cmdCtx = NULL;
@@ -581,6 +1909,7 @@ void SCAN_CommandForceNext(void) {
   if (!SCMD_Advance(scan.cmdCtx))
     SCMD_Rewind(scan.cmdCtx);
   scan.cmdRangeActive = false;
+  cmdPaused = false;
   ChangeState(SCAN_STATE_IDLE);
   gRedrawScreen = true;
 }
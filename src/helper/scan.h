@@ -38,6 +38,15 @@ typedef struct {
   uint8_t k; // коэффициент (2 по умолчанию)
 } NoiseHistory;
 
+// Детектор кандидатов на шаге TUNING
+typedef enum {
+  SCAN_ALGO_ADAPTIVE = 0, // EMA-пол + резкий фронт
+  SCAN_ALGO_FULLRESET,    // то же, пол заново на каждом проходе
+  SCAN_ALGO_STATISTICAL,  // rssi > mean + k·σ последних NOISE_HISTORY_SIZE
+  SCAN_ALGO_CALIBRATED,   // rssi > сохранённого пола диапазона (Floor.cal)
+  SCAN_ALGO_COUNT
+} ScanAlgo;
+
 // Контекст сканирования
 typedef struct {
   // Машина состояний
@@ -59,10 +68,13 @@ typedef struct {
 
   // Таймауты
   uint32_t warmupUs; // Задержка после переключения частоты (warmup)
+  uint32_t calWarmupUs; // Из таблицы WARMUP для текущего диапазона (0 — нет)
+  bool autoWarmup;      // Брать calWarmupUs, если он есть
   uint32_t checkDelayMs; // Задержка перед аппаратной проверкой squelch
 
   // Статистика
   uint32_t scanCycles;
+  uint32_t sweeps; // полных проходов диапазона
   uint32_t currentCps;
   uint32_t lastCpsTime;
   uint32_t radioTimer;
@@ -73,17 +85,11 @@ typedef struct {
 
   bool precise;
 
+  ScanAlgo algo;
   NoiseHistory noiseHist;
   uint8_t adaptiveThreshold; // вычисляемый порог
 
 } ScanContext;
-typedef enum {
-  SCAN_ALGO_ADAPTIVE = 0,
-  SCAN_ALGO_FULLRESET,
-  SCAN_ALGO_STATISTICAL,
-  SCAN_ALGO_CALIBRATED,
-  SCAN_ALGO_COUNT
-} ScanAlgo;
 
 // ============================================================================
 // API
@@ -92,6 +98,22 @@ typedef enum {
 void SCAN_Init(void);
 void SCAN_SetMode(ScanMode mode);
 ScanMode SCAN_GetMode(void);
+uint16_t SCAN_GetChannelCount(void); // каналов в SCAN_MODE_CHANNEL
+// Каналов в скан-листе; больше SCAN_GetChannelCount — лишние не влезли
+uint16_t SCAN_GetChannelListed(void);
+int16_t SCAN_GetChannel(void);       // номер в Channels.ch, -1 — нет
+
+// Приоритетные частоты: проход (диапазон, каналы) прерывается на них не
+// реже раза в интервал (0 — не заходить) и продолжается с той же точки
+void SCAN_ClearPriority(void);
+bool SCAN_AddPriority(uint32_t f); // false — список полон
+bool SCAN_RemovePriority(uint32_t f); // false — такой не было
+bool SCAN_IsPriority(uint32_t f);
+uint8_t SCAN_GetPriorityCount(void);
+void SCAN_SetPriorityInterval(uint16_t ms);
+bool SCAN_IsPriorityVisit(void);
+// Активные частоты прохода (по активности loot): навещаются между шагами
+uint8_t SCAN_GetHotCount(void);
 
 void SCAN_Check(void); // Главный цикл обновления
 
@@ -115,7 +137,33 @@ void SCAN_NextWhitelist(void);
 // Параметры
 void SCAN_SetDelay(uint32_t delay);
 uint32_t SCAN_GetDelay(void);
+void SCAN_SetAutoDelay(bool enabled); // warmup из калибровки (Warmup.cal)
+bool SCAN_IsAutoDelay(void);          // калиброванный warmup сейчас в деле
+bool SCAN_CalibrateDelay(void); // блокирующая калибровка текущего диапазона
+
+// Двухпроходный скан: грубо широким фильтром, потом точно вокруг находок
+void SCAN_SetCoarse(bool enabled);
+bool SCAN_IsCoarse(void);
+uint32_t SCAN_GetSweeps(void);
+
+// Поиск частотомером BK4819: сильные несущие в полосе фильтра сразу,
+// без перебора PLL
+void SCAN_SetHwHunt(bool enabled);
+bool SCAN_IsHwHunt(void);
+
+void SCAN_SetAlgo(ScanAlgo algo);
+ScanAlgo SCAN_GetAlgo(void);
+void SCAN_ForgetFloor(void); // CALIBRATED: переснять пол текущего диапазона
 uint32_t SCAN_GetCps(void);
+bool SCAN_IsSampleDue(void); // warmup истёк, замер ещё не снят — не спать
+// Приёмник не меряет (LISTENING, IDLE, пауза между проходами, VFO) —
+// флеш можно гнать на полной скорости
+bool SCAN_IsRfQuiet(void);
+// Можно писать настройки: шумодав закрыт, приёма нет и сканер не меряет.
+// Строже SCAN_IsRfQuiet — та про частоту SPI, а не про приём
+bool SCAN_IsPersistAllowed(void);
+// Постоять один цикл в конце текущего прохода: окно для отложенной записи
+void SCAN_RequestQuiet(void);
 
 // Инспекция командного режима
 SCMD_Command *SCAN_GetCurrentCommand(void);
@@ -128,8 +176,9 @@ void SCAN_HandleInterrupt(uint16_t int_bits);
 bool SCAN_IsSqOpen(void);
 const char *SCAN_GetStateName(void);
 
-extern const char *SCAN_MODE_NAMES[];
-extern const char *SCAN_STATE_NAMES[];
+extern const char *const SCAN_MODE_NAMES[];
+extern const char *const SCAN_STATE_NAMES[];
+extern const char *const SCAN_ALGO_NAMES[];
 ScanState SCAN_GetState(void);
 
 #endif
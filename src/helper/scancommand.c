@@ -3,6 +3,7 @@
 #include "../driver/uart.h"
 #include "../external/printf/printf.h"
 #include "../misc.h"
+#include "storage.h"
 
 // ============================================================================
 // Внутренние функции
@@ -77,6 +78,7 @@ bool SCMD_Init(SCMD_Context *ctx, const char *filename) {
   // Открываем файл с буфером
   struct lfs_file_config config = {.buffer = ctx->file_buffer, .attr_count = 0};
 
+  Storage_Close(filename);
   int err =
       lfs_file_opencfg(&gLfs, &ctx->file, filename, LFS_O_RDONLY, &config);
   if (err < 0) {
@@ -194,6 +196,7 @@ bool SCMD_CreateFile(const char *filename, SCMD_Command *commands,
   struct lfs_file_config config = {.buffer = buffer, .attr_count = 0};
 
   lfs_file_t file;
+  Storage_Close(filename);
   int err = lfs_file_opencfg(&gLfs, &file, filename,
                              LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, &config);
   if (err < 0) {
@@ -252,6 +255,7 @@ void SCMD_DebugDumpFile(const char *filename) {
   struct lfs_file_config config = {.buffer = buffer, .attr_count = 0};
   lfs_file_t file;
 
+  Storage_Close(filename);
   int err = lfs_file_opencfg(&gLfs, &file, filename, LFS_O_RDONLY, &config);
   if (err < 0) {
     Log("[SCMD] Cannot open %s for debug", filename);
@@ -25,7 +25,7 @@ typedef enum {
   SCMD_COUNT,
 } SCMD_Type;
 
-static const char *SCMD_NAMES[SCMD_COUNT] = {
+static const char *const SCMD_NAMES[SCMD_COUNT] = {
     [SCMD_CHANNEL] = "CHANNEL", // Одиночный канал
     [SCMD_RANGE] = "RANGE",     // Диапазон частот
     [SCMD_JUMP] = "JUMP",       // Безусловный переход
@@ -38,7 +38,7 @@ static const char *SCMD_NAMES[SCMD_COUNT] = {
     [SCMD_SETMODE] = "SETMODE", // Установка режима
 };
 
-static const char *SCMD_NAMES_SHORT[SCMD_COUNT] = {
+static const char *const SCMD_NAMES_SHORT[SCMD_COUNT] = {
     [SCMD_CHANNEL] = "CH", // Одиночный канал
     [SCMD_RANGE] = "RNG",  // Диапазон частот
     [SCMD_JUMP] = "JMP",   // Безусловный переход
@@ -2,6 +2,7 @@
 #include "../driver/lfs.h"
 #include "../driver/uart.h"
 #include "../ui/graphics.h"
+#include "storage.h"
 #include <stdlib.h>
 
 // Структура BMP заголовка для 1-битного изображения
@@ -50,6 +51,7 @@ static int writeFile(lfs_t *lfs, const char *path, const void *buffer,
   lfs_file_t file;
   uint8_t file_buffer[256];
   struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
+  Storage_Close(path);
   int err =
       lfs_file_opencfg(lfs, &file, path, LFS_O_WRONLY | LFS_O_CREAT, &config);
   if (err) {
@@ -73,6 +75,7 @@ static int readFile(lfs_t *lfs, const char *path, void *buffer,
   lfs_file_t file;
   uint8_t file_buffer[256];
   struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
+  Storage_Close(path);
   int err = lfs_file_opencfg(lfs, &file, path, LFS_O_RDONLY, &config);
   if (err) {
     Log("File not found: %s, err: %d", path, err);
@@ -242,6 +245,7 @@ static bool displayBMPFromLittleFS(const char *filename) {
   lfs_file_t file;
   uint8_t file_buffer[256];
   struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
+  Storage_Close(filename);
   int err = lfs_file_opencfg(&gLfs, &file, filename, LFS_O_RDONLY, &config);
   if (err) {
     Log("Failed to open file: %s", filename);
@@ -4,16 +4,89 @@
 #include "../ui/graphics.h"
 #include <string.h>
 
-// Статические буферы для кеша файлов (не используем malloc)
-static uint8_t file_buffer[256]; // Размер должен быть >= lfs->cfg->cache_size
+// ============================================================================
+// Кеш открытых файлов: повторный доступ к Bands.bnd, каналам, Settings.set
+// идёт без поиска имени в метаданных, а записи и чтения внутри одной
+// страницы — без SPI (кеш файла). Данные на флеш уходят на каждом Save
+// (lfs_file_sync), Storage_Flush закрывает всё — перед форматированием
+// ============================================================================
+
+#define STORAGE_OPEN_MAX 2  // открытых файлов (~380 байт RAM на каждый)
+#define STORAGE_NAME_MAX 24 // длиннее — файл закрывается после операции
+
+typedef struct {
+  lfs_file_t file;
+  struct lfs_file_config config;  // lfs держит указатель, пока файл открыт
+  uint8_t buffer[LFS_CACHE_SIZE]; // кеш файла, не используем malloc
+  char name[STORAGE_NAME_MAX];    // пусто — в кеше не держим
+  uint32_t used;                  // момент последнего доступа, 0 — слот свободен
+} OpenFile;
+
+static OpenFile openFiles[STORAGE_OPEN_MAX];
+static uint32_t useClock;
 
 // Вспомогательный буфер
 static uint8_t temp_buf[32];
 
-bool Storage_Init(const char *name, size_t item_size, uint16_t max_items) {
-  lfs_file_t file;
-  struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
+static void closeFile(OpenFile *f) {
+  if (!f->used)
+    return;
+  lfs_file_close(&gLfs, &f->file);
+  f->used = 0;
+  f->name[0] = '\0';
+}
+
+static OpenFile *findFile(const char *name) {
+  for (uint8_t i = 0; i < STORAGE_OPEN_MAX; ++i) {
+    if (openFiles[i].used && !strcmp(openFiles[i].name, name))
+      return &openFiles[i];
+  }
+  return NULL;
+}
+
+// Файл из кеша или открытый в самом давнем слоте; < 0 — ошибка lfs
+static int openFile(const char *name, int flags, OpenFile **out) {
+  OpenFile *f = findFile(name);
+  if (!f) {
+    f = &openFiles[0];
+    for (uint8_t i = 1; i < STORAGE_OPEN_MAX && f->used; ++i) {
+      if (openFiles[i].used < f->used)
+        f = &openFiles[i];
+    }
+    closeFile(f);
+
+    f->config = (struct lfs_file_config){.buffer = f->buffer, .attr_count = 0};
+    int err = lfs_file_opencfg(&gLfs, &f->file, name, flags, &f->config);
+    if (err < 0)
+      return err;
+    if (strlen(name) < STORAGE_NAME_MAX)
+      strcpy(f->name, name);
+  }
+  f->used = ++useClock;
+  *out = f;
+  return 0;
+}
 
+// Конец операции: ошибка или длинное имя — файл закрываем
+static void doneFile(OpenFile *f, bool ok) {
+  if (!ok || !f->name[0])
+    closeFile(f);
+}
+
+void Storage_Flush(void) {
+  for (uint8_t i = 0; i < STORAGE_OPEN_MAX; ++i)
+    closeFile(&openFiles[i]);
+}
+
+// Перед lfs_file_opencfg мимо Storage: второй дескриптор на тот же файл
+// видел бы старые данные и мог бы затереть записанное при закрытии
+void Storage_Close(const char *name) {
+  OpenFile *f = findFile(name);
+  if (f)
+    closeFile(f);
+}
+
+bool Storage_Init(const char *name, size_t item_size, uint16_t max_items) {
   if (lfs_file_exists(name)) {
     return false;
   }
@@ -22,9 +95,10 @@ bool Storage_Init(const char *name, size_t item_size, uint16_t max_items) {
   PrintMediumEx(LCD_XCENTER, LCD_YCENTER + 4, POS_C, C_FILL, "%s", name);
   ST7565_Blit();
 
-  // Используем lfs_file_opencfg с нашим буфером
-  int err = lfs_file_opencfg(&gLfs, &file, name,
-                             LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, &config);
+  OpenFile *f = findFile(name);
+  if (f)
+    closeFile(f);
+  int err = openFile(name, LFS_O_RDWR | LFS_O_CREAT | LFS_O_TRUNC, &f);
   if (err < 0) {
     printf("[Storage_Init] Cannot create file '%s': %d\n", name, err);
     return false;
@@ -42,16 +116,21 @@ bool Storage_Init(const char *name, size_t item_size, uint16_t max_items) {
       to_write = sizeof(temp_buf);
     }
 
-    lfs_ssize_t result = lfs_file_write(&gLfs, &file, temp_buf, to_write);
+    lfs_ssize_t result = lfs_file_write(&gLfs, &f->file, temp_buf, to_write);
     if (result != (lfs_ssize_t)to_write) {
       printf("[Storage_Init] Write failed: %ld\n", result);
-      lfs_file_close(&gLfs, &file);
+      closeFile(f);
       return false;
     }
     written += to_write;
   }
 
-  lfs_file_close(&gLfs, &file);
+  bool ok = lfs_file_sync(&gLfs, &f->file) >= 0;
+  doneFile(f, ok);
+  if (!ok) {
+    printf("[Storage_Init] Sync failed\n");
+    return false;
+  }
   printf("[Storage_Init] File '%s' created, size: %lu\n", name, total_size);
 
   gRedrawScreen = true;
@@ -59,44 +138,16 @@ bool Storage_Init(const char *name, size_t item_size, uint16_t max_items) {
   return true;
 }
 
-bool Storage_Save(const char *name, uint16_t num, const void *item,
-                  size_t item_size) {
-  lfs_file_t file;
-  struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
-
-  // Открываем с нашим буфером
-  int err =
-      lfs_file_opencfg(&gLfs, &file, name, LFS_O_RDWR | LFS_O_CREAT, &config);
-  if (err < 0) {
-    printf("[Storage_Save] Cannot open file '%s': %d\n", name, err);
+// Дописать нулями до required_size (при необходимости) и встать на offset
+static bool seekForWrite(OpenFile *f, uint32_t offset, uint32_t required_size) {
+  lfs_soff_t file_size = lfs_file_size(&gLfs, &f->file);
+  if (file_size < 0)
     return false;
-  }
-
-  // Узнаем текущий размер
-  lfs_soff_t file_size = lfs_file_size(&gLfs, &file);
-  if (file_size < 0) {
-    printf("[Storage_Save] Cannot get file size\n");
-    lfs_file_close(&gLfs, &file);
-    return false;
-  }
 
-  uint32_t offset = num * item_size;
-  uint32_t required_size = offset + item_size;
-
-  printf("[Storage_Save] file=%s num=%u offset=%lu file_size=%ld required=%lu\n",
-         name, num, offset, file_size, required_size);
-
-  // Если нужно расширить файл
   if (required_size > (uint32_t)file_size) {
-    printf("[Storage_Save] Extending file by %lu bytes\n", required_size - file_size);
-    // Переходим в конец
-    if (lfs_file_seek(&gLfs, &file, 0, LFS_SEEK_END) < 0) {
-      printf("[Storage_Save] Seek to end failed\n");
-      lfs_file_close(&gLfs, &file);
+    if (lfs_file_seek(&gLfs, &f->file, 0, LFS_SEEK_END) < 0)
       return false;
-    }
 
-    // Расширяем файл нулями
     uint32_t to_extend = required_size - file_size;
     memset(temp_buf, 0, sizeof(temp_buf));
 
@@ -105,89 +156,32 @@ bool Storage_Save(const char *name, uint16_t num, const void *item,
       if (chunk > sizeof(temp_buf))
         chunk = sizeof(temp_buf);
 
-      lfs_ssize_t written = lfs_file_write(&gLfs, &file, temp_buf, chunk);
-      if (written != (lfs_ssize_t)chunk) {
-        printf("[Storage_Save] Extend failed: %ld\n", written);
-        lfs_file_close(&gLfs, &file);
+      lfs_ssize_t written = lfs_file_write(&gLfs, &f->file, temp_buf, chunk);
+      if (written != (lfs_ssize_t)chunk)
         return false;
-      }
       to_extend -= chunk;
     }
-
-    // Возвращаемся к началу для записи данных
-    if (lfs_file_seek(&gLfs, &file, offset, LFS_SEEK_SET) < 0) {
-      printf("[Storage_Save] Seek failed after extend\n");
-      lfs_file_close(&gLfs, &file);
-      return false;
-    }
-  } else {
-    // Просто переходим к позиции
-    if (lfs_file_seek(&gLfs, &file, offset, LFS_SEEK_SET) < 0) {
-      printf("[Storage_Save] Seek failed\n");
-      lfs_file_close(&gLfs, &file);
-      return false;
-    }
   }
 
-  // Записываем данные
-  lfs_ssize_t written = lfs_file_write(&gLfs, &file, item, item_size);
-  lfs_file_close(&gLfs, &file);
+  return lfs_file_seek(&gLfs, &f->file, offset, LFS_SEEK_SET) >= 0;
+}
 
-  if (written != (lfs_ssize_t)item_size) {
-    printf("[Storage_Save] Write failed: %ld/%zu\n", written, item_size);
+// Встать на offset, если в файле есть required_size байт
+static bool seekForRead(OpenFile *f, uint32_t offset, uint32_t required_size) {
+  lfs_soff_t file_size = lfs_file_size(&gLfs, &f->file);
+  if (file_size < 0 || required_size > (uint32_t)file_size)
     return false;
-  }
+  return lfs_file_seek(&gLfs, &f->file, offset, LFS_SEEK_SET) >= 0;
+}
 
-  printf("[Storage_Save] OK: wrote %ld bytes at offset %lu\n", written, offset);
-  return true;
+bool Storage_Save(const char *name, uint16_t num, const void *item,
+                  size_t item_size) {
+  return Storage_SaveMultiple(name, num, item, item_size, 1);
 }
 
 bool Storage_Load(const char *name, uint16_t num, void *item,
                   size_t item_size) {
-  lfs_file_t file;
-  struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
-
-  int err = lfs_file_opencfg(&gLfs, &file, name, LFS_O_RDONLY, &config);
-  if (err < 0) {
-    printf("[Storage_Load] Cannot open file '%s': %d\n", name, err);
-    return false;
-  }
-
-  // Проверяем размер
-  lfs_soff_t file_size = lfs_file_size(&gLfs, &file);
-  if (file_size < 0) {
-    printf("[Storage_Load] Cannot get file size\n");
-    lfs_file_close(&gLfs, &file);
-    return false;
-  }
-
-  uint32_t offset = num * item_size;
-  uint32_t required_size = offset + item_size;
-
-  if (required_size > (uint32_t)file_size) {
-    printf("[Storage_Load] Offset %lu > file size %ld\n", required_size,
-           file_size);
-    lfs_file_close(&gLfs, &file);
-    return false;
-  }
-
-  // Переходим к позиции
-  if (lfs_file_seek(&gLfs, &file, offset, LFS_SEEK_SET) < 0) {
-    printf("[Storage_Load] Seek failed\n");
-    lfs_file_close(&gLfs, &file);
-    return false;
-  }
-
-  // Читаем данные
-  lfs_ssize_t read = lfs_file_read(&gLfs, &file, item, item_size);
-  lfs_file_close(&gLfs, &file);
-
-  if (read != (lfs_ssize_t)item_size) {
-    printf("[Storage_Load] Read failed: %ld/%zu\n", read, item_size);
-    return false;
-  }
-
-  return true;
+  return Storage_LoadMultiple(name, num, item, item_size, 1);
 }
 
 // Дополнительные функции
@@ -196,130 +190,137 @@ bool Storage_Exists(const char *name) {
   return lfs_stat(&gLfs, name, &info) == 0;
 }
 
+uint16_t Storage_Count(const char *name, size_t item_size) {
+  if (!item_size)
+    return 0;
+  // открытый файл знает свой размер — метаданные не трогаем
+  OpenFile *f = findFile(name);
+  if (f) {
+    lfs_soff_t size = lfs_file_size(&gLfs, &f->file);
+    return size < 0 ? 0 : size / item_size;
+  }
+  struct lfs_info info;
+  if (lfs_stat(&gLfs, name, &info) != 0)
+    return 0;
+  return info.size / item_size;
+}
+
 bool Storage_LoadMultiple(const char *name, uint16_t start_num, void *items,
                           size_t item_size, uint16_t count) {
   if (count == 0) {
     return true;
   }
 
-  lfs_file_t file;
-  struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
-
-  int err = lfs_file_opencfg(&gLfs, &file, name, LFS_O_RDONLY, &config);
+  OpenFile *f;
+  int err = openFile(name, LFS_O_RDWR, &f);
   if (err < 0) {
-    printf("[Storage_LoadMultiple] Cannot open file '%s': %d\n", name, err);
-    return false;
-  }
-
-  // Проверяем размер файла
-  lfs_soff_t file_size = lfs_file_size(&gLfs, &file);
-  if (file_size < 0) {
-    printf("[Storage_LoadMultiple] Cannot get file size\n");
-    lfs_file_close(&gLfs, &file);
+    printf("[Storage_Load] Cannot open file '%s': %d\n", name, err);
     return false;
   }
 
   uint32_t offset = start_num * item_size;
   uint32_t total_size = count * item_size;
-  uint32_t required_size = offset + total_size;
 
-  if (required_size > (uint32_t)file_size) {
-    printf("[Storage_LoadMultiple] Offset %lu > file size %ld\n", required_size,
-           file_size);
-    lfs_file_close(&gLfs, &file);
-    return false;
-  }
-
-  // Seek к начальной позиции ОДИН раз
-  if (lfs_file_seek(&gLfs, &file, offset, LFS_SEEK_SET) < 0) {
-    printf("[Storage_LoadMultiple] Seek failed\n");
-    lfs_file_close(&gLfs, &file);
+  if (!seekForRead(f, offset, offset + total_size)) {
+    printf("[Storage_Load] %s: no items %u..%u\n", name, start_num,
+           start_num + count - 1);
+    doneFile(f, true);
     return false;
   }
 
   // Читаем ВСЕ элементы ОДНИМ вызовом
-  lfs_ssize_t read = lfs_file_read(&gLfs, &file, items, total_size);
-  lfs_file_close(&gLfs, &file);
+  lfs_ssize_t read = lfs_file_read(&gLfs, &f->file, items, total_size);
+  bool ok = read == (lfs_ssize_t)total_size;
+  doneFile(f, ok);
 
-  if (read != (lfs_ssize_t)total_size) {
-    printf("[Storage_LoadMultiple] Read failed: %ld/%lu\n", read, total_size);
-    return false;
+  if (!ok) {
+    printf("[Storage_Load] Read failed: %ld/%lu\n", read, total_size);
   }
-
-  printf("[Storage_LoadMultiple] Loaded %u items in one read\n", count);
-  return true;
+  return ok;
 }
 
-// ============================================================================
-// НОВАЯ ФУНКЦИЯ: Пакетное сохранение нескольких элементов
-// ============================================================================
 bool Storage_SaveMultiple(const char *name, uint16_t start_num,
                           const void *items, size_t item_size, uint16_t count) {
   if (count == 0) {
     return true;
   }
 
-  lfs_file_t file;
-  struct lfs_file_config config = {.buffer = file_buffer, .attr_count = 0};
-
-  int err =
-      lfs_file_opencfg(&gLfs, &file, name, LFS_O_RDWR | LFS_O_CREAT, &config);
+  OpenFile *f;
+  int err = openFile(name, LFS_O_RDWR | LFS_O_CREAT, &f);
   if (err < 0) {
-    printf("[Storage_SaveMultiple] Cannot open file '%s': %d\n", name, err);
-    return false;
-  }
-
-  lfs_soff_t file_size = lfs_file_size(&gLfs, &file);
-  if (file_size < 0) {
-    printf("[Storage_SaveMultiple] Cannot get file size\n");
-    lfs_file_close(&gLfs, &file);
+    printf("[Storage_Save] Cannot open file '%s': %d\n", name, err);
     return false;
   }
 
   uint32_t offset = start_num * item_size;
   uint32_t total_size = count * item_size;
-  uint32_t required_size = offset + total_size;
 
-  // Расширяем файл если нужно
-  if (required_size > (uint32_t)file_size) {
-    if (lfs_file_seek(&gLfs, &file, 0, LFS_SEEK_END) < 0) {
-      lfs_file_close(&gLfs, &file);
-      return false;
-    }
+  if (!seekForWrite(f, offset, offset + total_size)) {
+    printf("[Storage_Save] %s: cannot extend/seek to %lu\n", name, offset);
+    closeFile(f);
+    return false;
+  }
 
-    uint32_t to_extend = required_size - file_size;
-    memset(temp_buf, 0, sizeof(temp_buf));
+  // Пишем ВСЕ элементы ОДНИМ вызовом; sync — данные на флеш, файл открыт
+  lfs_ssize_t written = lfs_file_write(&gLfs, &f->file, items, total_size);
+  bool ok = written == (lfs_ssize_t)total_size &&
+            lfs_file_sync(&gLfs, &f->file) >= 0;
+  doneFile(f, ok);
 
-    while (to_extend > 0) {
-      size_t chunk = to_extend;
-      if (chunk > sizeof(temp_buf))
-        chunk = sizeof(temp_buf);
+  if (!ok) {
+    printf("[Storage_Save] Write failed: %ld/%lu\n", written, total_size);
+  }
+  return ok;
+}
 
-      lfs_ssize_t written = lfs_file_write(&gLfs, &file, temp_buf, chunk);
-      if (written != (lfs_ssize_t)chunk) {
-        lfs_file_close(&gLfs, &file);
-        return false;
-      }
-      to_extend -= chunk;
+bool Storage_SaveChanged(const char *name, uint16_t num, const void *item,
+                         size_t item_size) {
+  OpenFile *f;
+  uint32_t offset = num * item_size;
+  // файла или элемента ещё нет — обычная запись с расширением
+  if (openFile(name, LFS_O_RDWR, &f) < 0)
+    return Storage_Save(name, num, item, item_size);
+  if (!seekForRead(f, offset, offset + item_size)) {
+    doneFile(f, true);
+    return Storage_Save(name, num, item, item_size);
+  }
+
+  // границы изменённого участка; чтение — из кеша файла или страницей SPI
+  const uint8_t *src = item;
+  uint32_t first = item_size, last = 0;
+  for (uint32_t pos = 0; pos < item_size;) {
+    size_t n = item_size - pos;
+    if (n > sizeof(temp_buf))
+      n = sizeof(temp_buf);
+    if (lfs_file_read(&gLfs, &f->file, temp_buf, n) != (lfs_ssize_t)n) {
+      closeFile(f);
+      return Storage_Save(name, num, item, item_size);
     }
+    for (size_t i = 0; i < n; ++i) {
+      if (temp_buf[i] == src[pos + i])
+        continue;
+      if (first == item_size)
+        first = pos + i;
+      last = pos + i;
+    }
+    pos += n;
   }
 
-  // Seek к начальной позиции
-  if (lfs_file_seek(&gLfs, &file, offset, LFS_SEEK_SET) < 0) {
-    lfs_file_close(&gLfs, &file);
-    return false;
+  if (first == item_size) {
+    doneFile(f, true);
+    return true; // на флеше то же самое — не пишем
   }
 
-  // Пишем ВСЕ элементы ОДНИМ вызовом
-  lfs_ssize_t written = lfs_file_write(&gLfs, &file, items, total_size);
-  lfs_file_close(&gLfs, &file);
+  uint32_t size = last - first + 1;
+  bool ok =
+      lfs_file_seek(&gLfs, &f->file, offset + first, LFS_SEEK_SET) >= 0 &&
+      lfs_file_write(&gLfs, &f->file, src + first, size) == (lfs_ssize_t)size &&
+      lfs_file_sync(&gLfs, &f->file) >= 0;
+  doneFile(f, ok);
 
-  if (written != (lfs_ssize_t)total_size) {
-    printf("[Storage_SaveMultiple] Write failed: %ld/%lu\n", written,
-           total_size);
-    return false;
+  if (!ok) {
+    printf("[Storage_Save] %s: write of %lu changed bytes failed\n", name,
+           size);
   }
-
-  printf("[Storage_SaveMultiple] Saved %u items in one write\n", count);
-  return true;
+  return ok;
 }
@@ -36,6 +36,33 @@ bool Storage_Save(const char *name, uint16_t num, const void *item,
                   size_t item_size);
 bool Storage_Exists(const char *name);
 
+/**
+ * Save item writing only the bytes that differ from the stored copy
+ * (nothing if the item is unchanged)
+ * @return true if the stored item matches after the call
+ */
+bool Storage_SaveChanged(const char *name, uint16_t num, const void *item,
+                         size_t item_size);
+
+/**
+ * Number of whole items in storage file (0 if file is missing)
+ * @param name File name
+ * @param item_size Size of one item in bytes
+ */
+uint16_t Storage_Count(const char *name, size_t item_size);
+
+/**
+ * Close all cached file handles (data is already on flash after each save).
+ * Call before lfs_format/lfs_remove/lfs_rename.
+ */
+void Storage_Flush(void);
+
+/**
+ * Close the cached handle of one file, if any. Call before opening the
+ * same file with raw lfs_file_* calls.
+ */
+void Storage_Close(const char *name);
+
 bool Storage_LoadMultiple(const char *name, uint16_t start_num, void *items,
                           size_t item_size, uint16_t count);
 bool Storage_SaveMultiple(const char *name, uint16_t start_num,
@@ -53,4 +80,7 @@ bool Storage_SaveMultiple(const char *name, uint16_t start_num,
 #define STORAGE_SAVE(name, num, item_ptr)                                      \
   Storage_Save(name, num, item_ptr, sizeof(*(item_ptr)))
 
+#define STORAGE_SAVE_CHANGED(name, num, item_ptr)                              \
+  Storage_SaveChanged(name, num, item_ptr, sizeof(*(item_ptr)))
+
 #endif // STORAGE_H
@@ -88,9 +88,8 @@ static void updateValRxCodeType(const MenuItem *item, bool up) {
   c->code.type = t;
   // Сброс значения при смене типа
   c->code.value = 0;
-  c->dirty[PARAM_RX_CODE] = true;
-  c->save_to_eeprom = true;
-  c->last_save_time = Now();
+  c->dirty |= PARAM_BIT(PARAM_RX_CODE);
+  RADIO_MarkForSave(c);
   RADIO_ApplySettings(c);
 }
 
@@ -102,9 +101,8 @@ static void updateValTxCodeType(const MenuItem *item, bool up) {
          : (t + CODE_TYPE_COUNT - 1) % CODE_TYPE_COUNT;
   c->tx_state.code.type = t;
   c->tx_state.code.value = 0;
-  c->dirty[PARAM_TX_CODE] = true;
-  c->save_to_eeprom = true;
-  c->last_save_time = Now();
+  c->dirty |= PARAM_BIT(PARAM_TX_CODE);
+  RADIO_MarkForSave(c);
   RADIO_ApplySettings(c);
 }
 static void setOffset(uint32_t v, uint32_t _) {
@@ -0,0 +1,174 @@
+#include "warmup.h"
+#include "../driver/bk4829.h"
+#include "../driver/hrtime.h"
+#include "../driver/uart.h"
+#include "../radio.h"
+#include "../settings.h"
+#include "storage.h"
+#include <string.h>
+
+#define WARMUP_FILE "Warmup.cal"
+
+#define CAL_PROBES 8        // точек по диапазону
+#define CAL_REF_US 5000     // заведомо дольше любого захвата PLL
+#define CAL_REF_READS 4     // усреднение опорного уровня
+#define CAL_TOL 3           // допуск RSSI (ед. по 0.5 dB)
+#define CAL_STABLE 3        // столько замеров подряд в допуске
+#define CAL_MARGIN_US 100   // запас сверху к худшей точке
+#define CAL_NO_INFO UINT32_MAX
+
+typedef struct {
+  uint16_t us[2][STEP_COUNT]; // [VHF, UHF][шаг], 0 — не калибровано
+} WarmupTable;
+
+static WarmupTable table;
+static bool loaded;
+
+static void Load(void) {
+  if (loaded)
+    return;
+  loaded = true;
+  if (!STORAGE_LOAD(WARMUP_FILE, 0, &table))
+    memset(&table, 0, sizeof(table));
+}
+
+static int8_t StepIndex(uint32_t stepF) {
+  for (uint8_t i = 0; i < STEP_COUNT; ++i) {
+    if (StepFrequencyTable[i] == stepF)
+      return i;
+  }
+  return -1;
+}
+
+// Тот же выбор, что BK4819_SelectFilter
+static uint8_t FilterIndex(uint32_t f) {
+  return f < SETTINGS_GetFilterBound() ? 0 : 1;
+}
+
+uint16_t WARMUP_ForRange(uint32_t start, uint32_t end, uint32_t stepF) {
+  int8_t s = StepIndex(stepF);
+  if (s < 0)
+    return 0;
+  Load();
+  uint16_t a = table.us[FilterIndex(start)][s];
+  uint16_t b = table.us[FilterIndex(end)][s];
+  // диапазон задевает некалиброванный фильтр — не угадываем
+  if (!a || !b)
+    return 0;
+  return a > b ? a : b;
+}
+
+void WARMUP_Clear(void) {
+  memset(&table, 0, sizeof(table));
+  loaded = true;
+  STORAGE_SAVE(WARMUP_FILE, 0, &table);
+}
+
+// ============================================================================
+// Калибровка
+// ============================================================================
+
+// Перестройка как в конвейере сканера (Pipe_Tune)
+static void Tune(uint32_t f) {
+  uint16_t reg30 = BK4819_ReadRegister(BK4819_REG_30);
+  if (!(reg30 & BK4819_REG_30_ENABLE_PLL_VCO))
+    BK4819_WriteRegister(BK4819_REG_30, reg30 | BK4819_REG_30_ENABLE_PLL_VCO);
+
+  RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, false, false);
+  RADIO_SetParam(ctx, PARAM_FREQUENCY, f, false);
+  RADIO_ApplySettings(ctx);
+}
+
+static void VcoOff(void) {
+  BK4819_WriteRegister(BK4819_REG_30,
+                       BK4819_ReadRegister(BK4819_REG_30) &
+                           ~BK4819_REG_30_ENABLE_PLL_VCO);
+}
+
+static uint16_t Diff(uint16_t a, uint16_t b) { return a > b ? a - b : b - a; }
+
+// Время от перестройки f - stepF -> f до устоявшегося RSSI, мкс.
+// CAL_NO_INFO — уровень с выключенным VCO не отличить от опорного
+static uint32_t MeasureSettle(uint32_t f, uint32_t stepF) {
+  // опорный уровень после заведомо полного захвата
+  Tune(f);
+  HRTIME_DelayUs(CAL_REF_US);
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < CAL_REF_READS; ++i)
+    sum += RADIO_GetRSSI(ctx);
+  uint16_t ref = sum / CAL_REF_READS;
+
+  // повторяем шаг сканера: стоим на соседней частоте, гасим VCO после
+  // замера и перестраиваемся
+  Tune(f - stepF);
+  HRTIME_DelayUs(CAL_REF_US);
+  VcoOff();
+  if (Diff(RADIO_GetRSSI(ctx), ref) <= CAL_TOL * 2)
+    return CAL_NO_INFO;
+
+  Tune(f);
+  uint32_t t0 = HRTIME_Now(); // как tunedAt в сканере — после записи
+  uint32_t firstOk = 0;
+  uint8_t stable = 0;
+  while (!HRTIME_Elapsed(t0, HRTIME_UsToTicks(CAL_REF_US))) {
+    uint16_t rssi = RADIO_GetRSSI(ctx);
+    uint32_t t = HRTIME_TicksToUs(HRTIME_Now() - t0);
+    if (Diff(rssi, ref) > CAL_TOL) {
+      stable = 0;
+      continue;
+    }
+    if (!stable++)
+      firstOk = t;
+    if (stable >= CAL_STABLE)
+      return firstOk;
+  }
+  return CAL_REF_US; // так и не устоялся
+}
+
+static uint16_t MarginAndClamp(uint32_t us) {
+  us += us / 4 + CAL_MARGIN_US;
+  if (us < WARMUP_MIN_US)
+    return WARMUP_MIN_US;
+  if (us > WARMUP_MAX_US)
+    return WARMUP_MAX_US;
+  return us;
+}
+
+uint16_t WARMUP_Calibrate(uint32_t start, uint32_t end, Step step) {
+  if (step >= STEP_COUNT || end < start)
+    return 0;
+  Load();
+
+  uint32_t stepF = StepFrequencyTable[step];
+  uint32_t steps = (end - start) / stepF;
+  uint32_t worst[2] = {0, 0};
+  bool seen[2] = {false, false};
+
+  RADIO_MuteAudioNow(gRadioState);
+
+  for (uint8_t i = 0; i < CAL_PROBES; ++i) {
+    uint32_t f = start + steps * i / (CAL_PROBES - 1) * stepF;
+    uint32_t us = MeasureSettle(f, stepF);
+    if (us == CAL_NO_INFO)
+      continue;
+    uint8_t fi = FilterIndex(f);
+    seen[fi] = true;
+    if (us > worst[fi])
+      worst[fi] = us;
+  }
+
+  uint16_t result = 0;
+  for (uint8_t fi = 0; fi < 2; ++fi) {
+    if (!seen[fi])
+      continue;
+    table.us[fi][step] = MarginAndClamp(worst[fi]);
+    if (table.us[fi][step] > result)
+      result = table.us[fi][step];
+  }
+
+  if (result) {
+    STORAGE_SAVE(WARMUP_FILE, 0, &table);
+  }
+  Log("[WARMUP] step=%u: %uus", stepF, result);
+  return result;
+}
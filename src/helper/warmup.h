@@ -0,0 +1,25 @@
+#ifndef WARMUP_H
+#define WARMUP_H
+
+#include "../inc/common.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Таблица warmup сканера: время от перестройки до честного RSSI, отдельно
+// для VHF/UHF фильтра и каждого шага. Хранится в LFS (Warmup.cal),
+// заполняется калибровкой по реальным кривым установления RSSI.
+
+#define WARMUP_MIN_US 200
+#define WARMUP_MAX_US 5000
+
+// Калиброванный warmup для диапазона, 0 — калибровки нет.
+// stepF — шаг в 10 Hz, как в scan.c
+uint16_t WARMUP_ForRange(uint32_t start, uint32_t end, uint32_t stepF);
+
+// Блокирующий замер по диапазону (пара сотен мс). Результат сразу пишется
+// в таблицу и в файл. Возвращает warmup, 0 — замерить не удалось.
+uint16_t WARMUP_Calibrate(uint32_t start, uint32_t end, Step step);
+
+void WARMUP_Clear(void);
+
+#endif
@@ -82,6 +82,11 @@ typedef enum {
   PARAM_COUNT,
 } ParamType;
 
+// VFOContext.dirty — бит на параметр
+#define PARAM_BIT(p) (1ull << (p))
+#define PARAM_ALL (PARAM_BIT(PARAM_COUNT) - 1)
+_Static_assert(PARAM_COUNT <= 64, "dirty: не больше 64 параметров");
+
 typedef enum {
   TX_UNKNOWN,
   TX_ON,
@@ -162,10 +167,9 @@ typedef struct {
   } __attribute__((packed)) tx_state;
 
   char name[10];
-  bool dirty[PARAM_COUNT]; // Флаги изменений
+  uint64_t dirty; // Флаги изменений, PARAM_BIT(p)
 
   const FreqBand *current_band; // Активный диапазон
-  uint32_t last_save_time; // Время последнего сохранения
   uint32_t frequency : 27; // Текущая частота
   uint32_t upconverter : 27; // Upconverter frequency shift
   uint16_t dev;
@@ -24,6 +24,8 @@ unsigned int SQRT16(unsigned int value) {
 }
 
 void _putchar(char c) { UART_Send((uint8_t *)&c, 1); }
+
+#ifndef HOST_BUILD
 void _init() {}
 
 // Самый простой обработчик HardFault
@@ -60,6 +62,7 @@ void HardFault_Handler(void) {
     GPIO_TogglePin(GPIO_PIN_FLASHLIGHT);
   }
 }
+#endif
 
 void ScanlistStr(uint32_t sl, char *buf) {
   for (uint8_t i = 0; i < 16; i++) {
@@ -19,6 +19,7 @@
 #include "helper/fsk2.h"
 #include "helper/lootlist.h"
 #include "helper/measurements.h"
+#include "helper/persist.h"
 #include "helper/storage.h"
 #include "inc/band.h"
 #include "inc/channel.h"
@@ -43,16 +44,16 @@ RadioState *gRadioState;
 ExtendedVFOContext *vfo;
 VFOContext *ctx;
 
-const char *TX_POWER_NAMES[4] = {"ULow", "Low", "Mid", "High"};
-const char *TX_OFFSET_NAMES[4] = {"None", "+", "-", "Freq"};
+const char *const TX_POWER_NAMES[4] = {"ULow", "Low", "Mid", "High"};
+const char *const TX_OFFSET_NAMES[4] = {"None", "+", "-", "Freq"};
 
-const char *RADIO_NAMES[3] = {
+const char *const RADIO_NAMES[3] = {
     [RADIO_BK4819] = "BK4819",
     [RADIO_BK1080] = "BK1080",
     [RADIO_SI4732] = "SI4732",
 };
 
-const char *FILTER_NAMES[4] = {
+const char *const FILTER_NAMES[4] = {
     [FILTER_VHF] = "VHF",
     [FILTER_UHF] = "UHF",
     [FILTER_OFF] = "Off",
@@ -113,7 +114,7 @@ static const ParamDesc PARAM_DESC[PARAM_COUNT] = {
 
 const char *RADIO_GetParamName(ParamType p) { return PARAM_DESC[p].name; }
 
-const char *TX_STATE_NAMES[7] = {
+const char *const TX_STATE_NAMES[7] = {
     [TX_UNKNOWN] = "TX Off",              //
     [TX_ON] = "TX On",                    //
     [TX_VOL_HIGH] = "CHARGING",           //
@@ -123,7 +124,7 @@ const char *TX_STATE_NAMES[7] = {
     [TX_POW_OVERDRIVE] = "HIGH POW",      //
 };
 
-const char *MOD_NAMES_BK4819[8] = {
+const char *const MOD_NAMES_BK4819[8] = {
     [MOD_FM] = "FM",   //
     [MOD_AM] = "AM",   //
     [MOD_LSB] = "DSB", //
@@ -133,14 +134,14 @@ const char *MOD_NAMES_BK4819[8] = {
     [MOD_WFM] = "WFM", //
 };
 
-const char *MOD_NAMES_SI47XX[8] = {
+const char *const MOD_NAMES_SI47XX[8] = {
     [SI47XX_AM] = "AM",
     [SI47XX_FM] = "FM",
     [SI47XX_LSB] = "LSB",
     [SI47XX_USB] = "USB",
 };
 
-const char *BW_NAMES_BK4819[10] = {
+const char *const BW_NAMES_BK4819[10] = {
     [BK4819_FILTER_BW_6k] = "U6K",   //
     [BK4819_FILTER_BW_7k] = "U7K",   //
     [BK4819_FILTER_BW_9k] = "N9k",   //
@@ -153,7 +154,7 @@ const char *BW_NAMES_BK4819[10] = {
     [BK4819_FILTER_BW_26k] = "W26k", //
 };
 
-const char *BW_NAMES_SI47XX[7] = {
+const char *const BW_NAMES_SI47XX[7] = {
     [SI47XX_BW_1_8_kHz] = "1.8k", //
     [SI47XX_BW_1_kHz] = "1k",     //
     [SI47XX_BW_2_kHz] = "2k",     //
@@ -163,7 +164,7 @@ const char *BW_NAMES_SI47XX[7] = {
     [SI47XX_BW_6_kHz] = "6k",     //
 };
 
-const char *BW_NAMES_SI47XX_SSB[6] = {
+const char *const BW_NAMES_SI47XX_SSB[6] = {
     [SI47XX_SSB_BW_0_5_kHz] = "0.5k", //
     [SI47XX_SSB_BW_1_0_kHz] = "1.0k", //
     [SI47XX_SSB_BW_1_2_kHz] = "1.2k", //
@@ -172,9 +173,9 @@ const char *BW_NAMES_SI47XX_SSB[6] = {
     [SI47XX_SSB_BW_4_kHz] = "4k",     //
 };
 
-const char *FLT_BOUND_NAMES[2] = {"240MHz", "280MHz"};
+const char *const FLT_BOUND_NAMES[2] = {"240MHz", "280MHz"};
 
-const char *SQ_TYPE_NAMES[4] = {"RNG", "RG", "RN", "R"};
+const char *const SQ_TYPE_NAMES[4] = {"RNG", "RG", "RN", "R"};
 
 const uint16_t StepFrequencyTable[15] = {
     2,   5,   50,  100,
@@ -323,7 +324,7 @@ static void saveVfo(uint8_t i, VFO *vfo) {
   }
 
   Log("[RADIO] SAVE VFO %u", i);
-  STORAGE_SAVE(vfosFileName, i, vfo);
+  STORAGE_SAVE_CHANGED(vfosFileName, i, vfo);
 }
 
 static void loadVfo(uint8_t i, VFO *vfo) {
@@ -736,10 +737,9 @@ static void RADIO_ApplyCorrections(VFOContext *ctx, bool save_to_eeprom) {
            ctx->frequency, band->min_freq, band->max_freq);
       ctx->frequency = band->max_freq;
     }
-    ctx->dirty[PARAM_FREQUENCY] = true; // Помечаем как dirty для применения
+    ctx->dirty |= PARAM_BIT(PARAM_FREQUENCY); // Помечаем как dirty для применения
     if (save_to_eeprom) {
-      ctx->save_to_eeprom = true;
-      ctx->last_save_time = Now();
+      RADIO_MarkForSave(ctx);
     }
   }
 
@@ -754,10 +754,9 @@ static void RADIO_ApplyCorrections(VFOContext *ctx, bool save_to_eeprom) {
            RADIO_GetParamValueString(
                ctx, PARAM_MODULATION)); // Используем новую мод для строки
       ctx->modulation = default_mod;
-      ctx->dirty[PARAM_MODULATION] = true;
+      ctx->dirty |= PARAM_BIT(PARAM_MODULATION);
       if (save_to_eeprom) {
-        ctx->save_to_eeprom = true;
-        ctx->last_save_time = Now();
+        RADIO_MarkForSave(ctx);
       }
     }
   }
@@ -772,10 +771,9 @@ static void RADIO_ApplyCorrections(VFOContext *ctx, bool save_to_eeprom) {
            ctx->bandwidth, default_bw,
            RADIO_GetParamValueString(ctx, PARAM_BANDWIDTH));
       ctx->bandwidth = default_bw;
-      ctx->dirty[PARAM_BANDWIDTH] = true;
+      ctx->dirty |= PARAM_BIT(PARAM_BANDWIDTH);
       if (save_to_eeprom) {
-        ctx->save_to_eeprom = true;
-        ctx->last_save_time = Now();
+        RADIO_MarkForSave(ctx);
       }
     }
   }
@@ -835,13 +833,13 @@ static void RADIO_UpdateCurrentBand(VFOContext *ctx) {
       band->num_available_mods > 0) {
     ctx->modulation_index = 0;
     ctx->modulation = band->available_mods[0];
-    ctx->dirty[PARAM_MODULATION] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_MODULATION);
   }
   if (ctx->bandwidth_index >= band->num_available_bandwidths &&
       band->num_available_bandwidths > 0) {
     ctx->bandwidth_index = 0;
     ctx->bandwidth = band->available_bandwidths[0];
-    ctx->dirty[PARAM_BANDWIDTH] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_BANDWIDTH);
   }
 }
 
@@ -934,7 +932,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
         }
       }
     }
-    ctx->dirty[PARAM_MODULATION] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_MODULATION);
 
     switch (ctx->modulation) {
     case MOD_LSB:
@@ -975,7 +973,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
         }
       }
     }
-    ctx->dirty[PARAM_BANDWIDTH] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_BANDWIDTH);
     break;
   case PARAM_RX_CODE:
     ctx->code.value = value;
@@ -1003,8 +1001,8 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
         ctx->power, RADIO_GetParam(ctx, PARAM_TX_FREQUENCY_FACT));
 
     ctx->tx_state.pa_enabled = true;
-    ctx->dirty[PARAM_TX_POWER] = true;
-    ctx->dirty[PARAM_TX_POWER_AMPLIFIER] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_TX_POWER);
+    ctx->dirty |= PARAM_BIT(PARAM_TX_POWER_AMPLIFIER);
   } break;
   case PARAM_TX_POWER:
     ctx->tx_state.power_level = value;
@@ -1069,7 +1067,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
   case PARAM_UPCONVERTER:
     ctx->upconverter = value;
     // Need to retune with new upconverter value
-    ctx->dirty[PARAM_FREQUENCY] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_FREQUENCY);
     break;
   case PARAM_SQUELCH_VALUE:
     ctx->squelch.value = value;
@@ -1080,9 +1078,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
   case PARAM_RADIO:
     ctx->radio_type = value;
     // RADIO_UpdateCurrentBand(ctx);
-    for (uint8_t i = 0; i < PARAM_COUNT; ++i) {
-      ctx->dirty[i] = true;
-    }
+    ctx->dirty = PARAM_ALL;
     break;
   case PARAM_FREQUENCY_FACT:
   case PARAM_TX_FREQUENCY_FACT:
@@ -1108,13 +1104,12 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
 
   // Always mark dirty to ensure param is applied to hardware,
   // even if value hasn't changed (important for initial setup)
-  ctx->dirty[param] = true;
+  ctx->dirty |= PARAM_BIT(param);
 
   // Если значение изменилось и требуется сохранение - устанавливаем флаг
   if (save_to_eeprom && (old_value != value)) {
     LogC(LOG_C_BRIGHT_YELLOW, "[RADIO] SAVE %s", PARAM_NAMES(param));
-    ctx->save_to_eeprom = true;
-    ctx->last_save_time = Now();
+    RADIO_MarkForSave(ctx);
   }
 }
 
@@ -1321,44 +1316,52 @@ static spf_ptr setParamForRadio[] = {
     [RADIO_SI4732] = &setParamSI4732,
 };
 
+// Параметры без записи в железо: при применении только сбрасываются
+#define PARAM_NO_HW                                                            \
+  (PARAM_BIT(PARAM_STEP) | PARAM_BIT(PARAM_POWER) |                            \
+   PARAM_BIT(PARAM_TX_FREQUENCY) | PARAM_BIT(PARAM_TX_OFFSET) |                \
+   PARAM_BIT(PARAM_TX_OFFSET_DIR) | PARAM_BIT(PARAM_TX_STATE) |                \
+   PARAM_BIT(PARAM_TX_CODE) | PARAM_BIT(PARAM_RX_CODE) |                       \
+   PARAM_BIT(PARAM_RSSI) | PARAM_BIT(PARAM_NOISE) | PARAM_BIT(PARAM_GLITCH) |  \
+   PARAM_BIT(PARAM_SNR) | PARAM_BIT(PARAM_PRECISE_F_CHANGE))
+
 // Применение настроек
 void RADIO_ApplySettings(VFOContext *ctx) {
-  if (ctx->dirty[PARAM_RADIO]) {
+  if (ctx->dirty & PARAM_BIT(PARAM_RADIO)) {
     LogC(LOG_C_BRIGHT_MAGENTA, "[RADIO] =%s",
          RADIO_GetParamValueString(ctx, PARAM_RADIO));
-    ctx->dirty[PARAM_RADIO] = false;
+    ctx->dirty &= ~PARAM_BIT(PARAM_RADIO);
 
     ExtendedVFOContext *ev = RADIO_GetCurrentVFO(gRadioState);
     RXSW_SwitchTo(&gRadioState->rx_switch, ctx, ev ? ev->is_open : false);
   }
 
   const bool needSetupToneDetection =
-      (ctx->dirty[PARAM_RX_CODE] || ctx->dirty[PARAM_TX_CODE] ||
-       ctx->dirty[PARAM_TX_STATE] || ctx->dirty[PARAM_RADIO]) &&
+      (ctx->dirty & (PARAM_BIT(PARAM_RX_CODE) | PARAM_BIT(PARAM_TX_CODE) |
+                     PARAM_BIT(PARAM_TX_STATE) | PARAM_BIT(PARAM_RADIO))) &&
       ctx->radio_type == RADIO_BK4819;
 
-  for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    if (!ctx->dirty[p]) {
-      continue;
-    }
+  ctx->dirty &= ~PARAM_NO_HW;
 
-    switch (p) {
-    case PARAM_STEP:
-    case PARAM_POWER:
-    case PARAM_TX_FREQUENCY:
-    case PARAM_TX_OFFSET:
-    case PARAM_TX_OFFSET_DIR:
-    case PARAM_TX_STATE:
-    case PARAM_TX_CODE:
-    case PARAM_RX_CODE:
-    case PARAM_RSSI:
-    case PARAM_NOISE:
-    case PARAM_GLITCH:
-    case PARAM_SNR:
-    case PARAM_PRECISE_F_CHANGE:
-      ctx->dirty[p] = false;
-      continue;
-    }
+  // перестройка сканера и мультивотча — только частота
+  if (ctx->dirty == PARAM_BIT(PARAM_FREQUENCY) && !needSetupToneDetection) {
+    if (setParamForRadio[ctx->radio_type](ctx, PARAM_FREQUENCY))
+      ctx->dirty = 0;
+    return;
+  }
+
+  // параметры BK4819 пересекаются по регистрам — пишем одним пакетом
+  const bool batched = ctx->radio_type == RADIO_BK4819;
+  if (batched)
+    BK4819_BeginBatch();
+
+  // по возрастанию ParamType (SI47xx: модуляция до частоты); параметр,
+  // помеченный по ходу, тоже подхватываем
+  uint64_t seen = 0;
+  uint64_t pending;
+  while ((pending = ctx->dirty & ~seen)) {
+    uint8_t p = __builtin_ctzll(pending);
+    seen |= PARAM_BIT(p);
 
     if (!setParamForRadio[ctx->radio_type](ctx, p)) {
 #ifdef DEBUG_PARAMS
@@ -1367,7 +1370,7 @@ void RADIO_ApplySettings(VFOContext *ctx) {
 #endif
       continue;
     }
-    ctx->dirty[p] = false;
+    ctx->dirty &= ~PARAM_BIT(p);
 #ifdef DEBUG_PARAMS
     LogC(LOG_C_BRIGHT_WHITE, "[SET] %-12s -> %s", PARAM_NAMES(p),
          RADIO_GetParamValueString(ctx, p));
@@ -1377,6 +1380,9 @@ void RADIO_ApplySettings(VFOContext *ctx) {
   if (needSetupToneDetection) {
     RADIO_SetupToneDetection(ctx);
   }
+
+  if (batched)
+    BK4819_EndBatch();
 }
 
 // Начать передачу
@@ -1497,11 +1503,8 @@ void RADIO_InitState(RadioState *state, uint8_t num_vfos) {
 void RADIO_CheckAndSaveVFO(RadioState *state) {
   for (uint8_t i = 0; i < state->num_vfos; ++i) {
     VFOContext *ctx = &state->vfos[i].context;
-    uint16_t num = state->vfos[i].vfo_ch_index;
 
-    if (ctx->save_to_eeprom &&
-        (Now() - ctx->last_save_time >= RADIO_SAVE_DELAY_MS)) {
-      LogC(LOG_C_BRIGHT_YELLOW, "TRYING TO SAVE PARAM");
+    if (ctx->save_to_eeprom) {
 
       VFO vfo;
       RADIO_SaveVFOToStorage(state, i, &vfo);
@@ -1513,6 +1516,14 @@ void RADIO_CheckAndSaveVFO(RadioState *state) {
   }
 }
 
+static void saveVfosDelayed(void) { RADIO_CheckAndSaveVFO(gRadioState); }
+
+// Запись VFO — отложенно, одной пачкой на серию правок (PERSIST)
+void RADIO_MarkForSave(VFOContext *ctx) {
+  ctx->save_to_eeprom = true;
+  PERSIST_Mark(saveVfosDelayed, RADIO_SAVE_DELAY_MS);
+}
+
 static bool RADIO_SwitchVFOTemp(RadioState *state, uint8_t vfo_index) {
   if (vfo_index >= state->num_vfos) {
     return false;
@@ -1526,8 +1537,10 @@ static bool RADIO_SwitchVFOTemp(RadioState *state, uint8_t vfo_index) {
   VFOContext *oldCtx = &state->vfos[state->active_vfo_index].context;
   VFOContext *newCtx = &state->vfos[vfo_index].context;
 
+  newCtx->dirty = 0;
   for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    newCtx->dirty[p] = RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p);
+    if (RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p))
+      newCtx->dirty |= PARAM_BIT(p);
   }
 
   // Activate new VFO
@@ -1549,16 +1562,16 @@ bool RADIO_SwitchVFO(RadioState *state, uint8_t vfo_index) {
 
   Log("[RADIO] SwitchVFO");
 
-  RADIO_CheckAndSaveVFO(state);
-
   // Deactivate current VFO
   state->vfos[state->active_vfo_index].is_active = false;
 
   VFOContext *oldCtx = &state->vfos[state->active_vfo_index].context;
   VFOContext *newCtx = &state->vfos[vfo_index].context;
 
+  newCtx->dirty = 0;
   for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    newCtx->dirty[p] = RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p);
+    if (RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p))
+      newCtx->dirty |= PARAM_BIT(p);
   }
 
   // mute previous vfo (fast fix)
@@ -1776,8 +1789,7 @@ bool RADIO_NextChannel(bool next) {
       RADIO_ApplySettings(&vfo->context);
 
       // Помечаем для сохранения в EEPROM
-      ctx->save_to_eeprom = true;
-      ctx->last_save_time = Now();
+      RADIO_MarkForSave(ctx);
 
       gRedrawScreen = true;
 
@@ -1825,8 +1837,7 @@ bool RADIO_ToggleVFOMode(RadioState *state, uint8_t vfo_index) {
   RADIO_ApplySettings(&vfo->context);
 
   // Помечаем для сохранения в EEPROM
-  ctx->save_to_eeprom = true;
-  ctx->last_save_time = Now();
+  RADIO_MarkForSave(ctx);
 
   gRedrawScreen = true;
 
@@ -1865,10 +1876,15 @@ static void RADIO_UpdateMeasurement(ExtendedVFOContext *vfo) {
   // Log("Update MSM");
   VFOContext *ctx = &vfo->context;
   vfo->msm.f = ctx->frequency;
-  vfo->msm.rssi = RADIO_GetRSSI(ctx);
-  vfo->msm.noise = BK4819_GetNoise();
-  vfo->msm.glitch = BK4819_GetGlitch();
-  vfo->msm.snr = RADIO_GetSNR(ctx);
+  if (ctx->radio_type == RADIO_BK4819) {
+    BK4819_ReadMeasurementBurst(&vfo->msm, true);
+    vfo->msm.snr = ConvertDomain(vfo->msm.snr, 24, 170, 0, 30);
+  } else {
+    vfo->msm.rssi = RADIO_GetRSSI(ctx);
+    vfo->msm.noise = BK4819_GetNoise();
+    vfo->msm.glitch = BK4819_GetGlitch();
+    vfo->msm.snr = RADIO_GetSNR(ctx);
+  }
   vfo->msm.open = RADIO_CheckSquelch(ctx);
   if (!gMonitorMode && ctx->radio_type == RADIO_BK4819) {
     LOOT_Update(&vfo->msm);
@@ -2001,9 +2017,7 @@ void RADIO_LoadVFOs(RadioState *state) {
   state->num_vfos = vfoIdx;
 
   VFOContext *ctx = &state->vfos[state->active_vfo_index].context;
-  for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    ctx->dirty[p] = true;
-  }
+  ctx->dirty = PARAM_ALL;
 
   RADIO_ApplySettings(ctx);
   updateContext();
@@ -10,14 +10,14 @@
 #define SQL_DELAY 150  // Увеличено с 90 — реже опрашиваем регистры, меньше SPI шума
 
 extern const char *PARAM_NAMES[];
-extern const char *TX_STATE_NAMES[7];
-extern const char *FLT_BOUND_NAMES[2];
-extern const char *BW_NAMES_BK4819[10];
-extern const char *BW_NAMES_SI47XX[7];
-extern const char *BW_NAMES_SI47XX_SSB[6];
-extern const char *SQ_TYPE_NAMES[4];
-extern const char *MOD_NAMES_BK4819[8];
-extern const char *RADIO_NAMES[3];
+extern const char *const TX_STATE_NAMES[7];
+extern const char *const FLT_BOUND_NAMES[2];
+extern const char *const BW_NAMES_BK4819[10];
+extern const char *const BW_NAMES_SI47XX[7];
+extern const char *const BW_NAMES_SI47XX_SSB[6];
+extern const char *const SQ_TYPE_NAMES[4];
+extern const char *const MOD_NAMES_BK4819[8];
+extern const char *const RADIO_NAMES[3];
 
 extern const uint16_t StepFrequencyTable[15];
 
@@ -50,7 +50,8 @@ void RADIO_Init(VFOContext *ctx, Radio radio_type);
 void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
                     bool save_to_eeprom);
 
-void RADIO_CheckAndSaveVFO(RadioState *state);
+void RADIO_CheckAndSaveVFO(RadioState *state); // сразу пишет помеченные VFO
+void RADIO_MarkForSave(VFOContext *ctx);         // записать отложенно
 
 // Применение настроек
 void RADIO_ApplySettings(VFOContext *ctx);
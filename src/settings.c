@@ -8,34 +8,33 @@
 #include "driver/uart.h"
 #include "external/printf/printf.h"
 #include "helper/measurements.h"
+#include "helper/persist.h"
 #include "helper/storage.h"
 #include "misc.h"
 #include "radio.h"
 #include <stdint.h>
 #include <string.h>
 
-static uint32_t saveTime;
+#define SETTINGS_SAVE_DELAY_MS 1000
 
 bool dirty[SETTING_COUNT];
 
-static const uint16_t BAT_CAL_MIN = 1900;
-
 static const char *YES_NO[] = {"No", "Yes"};
 static const char *ON_OFF[] = {"Off", "On"};
 
 uint8_t BL_TIME_VALUES[7] = {0, 5, 10, 20, 60, 120, 255};
 
-const char *BL_SQL_MODE_NAMES[3] = {"Off", "On", "Open"};
-const char *CH_DISPLAY_MODE_NAMES[3] = {"Name+F", "F", "Name"};
-const char *rogerNames[2] = {"None", "Tiny"};
-const char *FC_TIME_NAMES[4] = {"0.2s", "0.4s", "0.8s", "1.6s"};
-const char *MW_NAMES[4] = {
+const char *const BL_SQL_MODE_NAMES[3] = {"Off", "On", "Open"};
+const char *const CH_DISPLAY_MODE_NAMES[3] = {"Name+F", "F", "Name"};
+const char *const rogerNames[2] = {"None", "Tiny"};
+const char *const FC_TIME_NAMES[4] = {"0.2s", "0.4s", "0.8s", "1.6s"};
+const char *const MW_NAMES[4] = {
     [MW_OFF] = "Off",
     [MW_ON] = "On",
     [MW_SWITCH] = "Switch",
     [MW_EXTRA] = "Extra",
 };
-const char *EEPROM_TYPE_NAMES[6] = {
+const char *const EEPROM_TYPE_NAMES[6] = {
     [EEPROM_BL24C64] = "64 #",   //
     [EEPROM_BL24C128] = "128",   //
     [EEPROM_BL24C256] = "256",   //
@@ -43,20 +42,17 @@ const char *EEPROM_TYPE_NAMES[6] = {
     [EEPROM_BL24C1024] = "1024", //
     [EEPROM_M24M02] = "M02",     //
 };
-uint32_t SCAN_TIMEOUTS[15] = {
+const uint32_t SCAN_TIMEOUTS[15] = {
     0,         100,       200,           300,           400,
     500,       1000 * 1,  1000 * 3,      1000 * 5,      1000 * 10,
     1000 * 30, 1000 * 60, 1000 * 60 * 2, 1000 * 60 * 5, UINT32_MAX,
 };
 
-char *SCAN_TIMEOUT_NAMES[15] = {
+const char *const SCAN_TIMEOUT_NAMES[15] = {
     "0",  "100ms", "200ms", "300ms", "400ms", "500ms", "1s",   "3s",
     "5s", "10s",   "30s",   "1m",    "2m",    "5m",    "None",
 };
 
-static const uint8_t PATCH3_PREAMBLE[] = {0x15, 0x00, 0x03, 0x74,
-                                          0x0b, 0xd4, 0x84, 0x60};
-
 Settings gSettings = {
     .eepromType = EEPROM_UNKNOWN,
     .batsave = 4,
@@ -114,20 +110,31 @@ const uint16_t PAGE_SIZES[6] = {
     [EEPROM_M24M02] = 256,    //
 };
 
+// Пишет только изменившиеся байты; обычно вызывается отложенно (PERSIST)
 void SETTINGS_Save(void) {
-  STORAGE_SAVE("Settings.set", 0, &gSettings);
+  STORAGE_SAVE_CHANGED("Settings.set", 0, &gSettings);
+  memset(dirty, 0, sizeof(dirty));
 }
 
 void SETTINGS_Load(void) {
   STORAGE_LOAD("Settings.set", 0, &gSettings);
 }
 
-void SETTINGS_DelayedSave(void) { SETTINGS_Save(); }
+void SETTINGS_DelayedSave(void) {
+  PERSIST_Mark(SETTINGS_Save, SETTINGS_SAVE_DELAY_MS);
+}
 
 uint32_t SETTINGS_GetFilterBound(void) {
   return gSettings.bound_240_280 ? VHF_UHF_BOUND2 : VHF_UHF_BOUND1;
 }
 
+// 0 в старых файлах настроек (reserved) — прежние 500 мс
+uint16_t SETTINGS_GetPrioIntervalMs(void) {
+  if (gSettings.prioInterval == PRIO_INTERVAL_OFF)
+    return 0;
+  return 500 + 250 * gSettings.prioInterval;
+}
+
 uint32_t SETTINGS_GetEEPROMSize(void) {
   return EEPROM_SIZES[gSettings.eepromType];
 }
@@ -196,6 +203,8 @@ uint32_t SETTINGS_GetValue(Setting s) {
     return gSettings.sqlCloseTime;
   case SETTING_SKIPGARBAGEFREQUENCIES:
     return gSettings.skipGarbageFrequencies;
+  case SETTING_PRIO_INTERVAL:
+    return gSettings.prioInterval;
   case SETTING_ACTIVEVFO:
     return gSettings.activeVFO;
   case SETTING_BACKLIGHTONSQUELCH:
@@ -332,6 +341,9 @@ void SETTINGS_SetValue(Setting s, uint32_t v) {
   case SETTING_SKIPGARBAGEFREQUENCIES:
     gSettings.skipGarbageFrequencies = v;
     break;
+  case SETTING_PRIO_INTERVAL:
+    gSettings.prioInterval = v;
+    break;
   case SETTING_ACTIVEVFO:
     gSettings.activeVFO = v;
     break;
@@ -364,7 +376,7 @@ void SETTINGS_SetValue(Setting s, uint32_t v) {
     break;
   case SETTING_BOUND240_280:
     gSettings.bound_240_280 = v;
-    ctx->dirty[PARAM_FILTER] = true; // filter update
+    ctx->dirty |= PARAM_BIT(PARAM_FILTER); // filter update
     RADIO_ApplySettings(ctx);
     break;
   case SETTING_NOLISTEN:
@@ -397,7 +409,7 @@ void SETTINGS_SetValue(Setting s, uint32_t v) {
 
   if (v != ov) {
     dirty[s] = true;
-    saveTime = Now() + 1000;
+    SETTINGS_DelayedSave();
   }
 }
 
@@ -476,6 +488,11 @@ const char *SETTINGS_GetValueString(Setting s) {
   case SETTING_FREQ_CORRECTION:
     sprintf(buf, "%+dHz", v * 10);
     break;
+  case SETTING_PRIO_INTERVAL:
+    if (v == PRIO_INTERVAL_OFF)
+      return ON_OFF[0];
+    sprintf(buf, "%ums", SETTINGS_GetPrioIntervalMs());
+    break;
 
   case SETTING_MIC:
   case SETTING_COUNT:
@@ -603,6 +620,7 @@ void SETTINGS_IncDecValue(Setting s, bool inc) {
     ma = 256;
     break;
   case SETTING_MIC:
+  case SETTING_PRIO_INTERVAL:
     ma = 16;
     break;
 
@@ -630,17 +648,7 @@ void SETTINGS_IncDecValue(Setting s, bool inc) {
   SETTINGS_SetValue(s, IncDecU(v, mi, ma, inc));
 }
 
-void SETTINGS_UpdateSave() {
-  if (saveTime && Now() > saveTime) {
-    saveTime = 0;
-    SETTINGS_Save();
-    for (uint8_t i = 0; i < SETTING_COUNT; ++i) {
-      dirty[i] = false;
-    }
-  }
-}
-
 void SETTINGS_MarkDirty(Setting s) {
   dirty[s] = true;
-  saveTime = Now() + 1000;
+  SETTINGS_DelayedSave();
 }
@@ -7,6 +7,7 @@
 #define getsize(V) char (*__ #V)(void)[sizeof(V)] = 1;
 
 #define SCANLIST_ALL 0
+#define PRIO_INTERVAL_OFF 15
 
 typedef enum {
   SETTING_EEPROMTYPE,
@@ -52,6 +53,7 @@ typedef enum {
   SETTING_MULTIWATCH,
   SETTING_FREQ_CORRECTION,
   SETTING_INVERT_BUTTONS,
+  SETTING_PRIO_INTERVAL,
 
   SETTING_AF_RX_300,
   SETTING_AF_RX_3K,
@@ -119,12 +121,12 @@ typedef enum {
   EEPROM_UNKNOWN,
 } EEPROMType;
 
-extern uint32_t SCAN_TIMEOUTS[15];
-extern char *SCAN_TIMEOUT_NAMES[15];
-extern const char *EEPROM_TYPE_NAMES[6];
+extern const uint32_t SCAN_TIMEOUTS[15];
+extern const char *const SCAN_TIMEOUT_NAMES[15];
+extern const char *const EEPROM_TYPE_NAMES[6];
 extern const uint32_t EEPROM_SIZES[6];
 extern const uint16_t PAGE_SIZES[6];
-extern const char *MW_NAMES[4];
+extern const char *const MW_NAMES[4];
 
 typedef struct {
   uint32_t upconverter : 27;
@@ -139,7 +141,7 @@ typedef struct {
   uint8_t backlight : 4;
   uint8_t mic : 4;
 
-  uint8_t reserved3 : 4;
+  uint8_t prioInterval : 4; // 500 мс + 250 мс * v, PRIO_INTERVAL_OFF — нет
   uint8_t batsave : 4;
 
   uint8_t vox : 4;
@@ -198,15 +200,16 @@ typedef struct {
 
 extern Settings gSettings;
 extern uint8_t BL_TIME_VALUES[7];
-extern const char *BL_SQL_MODE_NAMES[3];
-extern const char *CH_DISPLAY_MODE_NAMES[3];
-extern const char *rogerNames[2];
-extern const char *FC_TIME_NAMES[4];
+extern const char *const BL_SQL_MODE_NAMES[3];
+extern const char *const CH_DISPLAY_MODE_NAMES[3];
+extern const char *const rogerNames[2];
+extern const char *const FC_TIME_NAMES[4];
 
 void SETTINGS_Save();
 void SETTINGS_Load();
 void SETTINGS_DelayedSave();
 uint32_t SETTINGS_GetFilterBound();
+uint16_t SETTINGS_GetPrioIntervalMs(void); // 0 — приоритетные не навещать
 uint32_t SETTINGS_GetEEPROMSize();
 uint16_t SETTINGS_GetPageSize();
 bool SETTINGS_IsPatchPresent();
@@ -216,7 +219,6 @@ void SETTINGS_SetValue(Setting s, uint32_t v);
 const char *SETTINGS_GetValueString(Setting s);
 void SETTINGS_IncDecValue(Setting s, bool inc);
 
-void SETTINGS_UpdateSave();
 void SETTINGS_MarkDirty(Setting s);
 
 extern bool dirty[SETTING_COUNT];
@@ -18,11 +18,13 @@
 #include "external/printf/printf.h"
 #include "helper/audio_rec.h"
 #include "helper/bands.h"
+#include "helper/bktrace.h"
 #include "helper/fsk2.h"
 #include "helper/keymap.h"
 #include "helper/lootlist.h"
 #include "helper/measurements.h"
 #include "helper/menu.h"
+#include "helper/persist.h"
 #include "helper/regs-menu.h"
 #include "helper/scan.h"
 #include "helper/screenshot.h"
@@ -100,6 +102,7 @@ static void resetFull(void) {
 
 static void reset(void) {
   showMsg("Formatting...");
+  Storage_Flush();
   lfs_format(&gLfs, &gStorage.config);
   lfs_mount(&gLfs, &gStorage.config);
 
@@ -145,13 +148,20 @@ static void loadSettingsOrReset(void) {
 static bool checkKeylock(KEY_State_t state, KEY_Code_t key) {
   if (state == KEY_LONG_PRESSED && key == KEY_F) {
     gSettings.keylock = !gSettings.keylock;
-    SETTINGS_Save();
+    SETTINGS_DelayedSave();
     return true;
   }
   if (gSettings.keylock && state == KEY_LONG_PRESSED && key == KEY_8) {
     captureScreen();
     return true;
   }
+#ifdef BK4819_TRACE
+  if (gSettings.keylock && state == KEY_LONG_PRESSED && key == KEY_9) {
+    BKTRACE_DumpUart();
+    BKTRACE_Save("Bus.bkt");
+    return true;
+  }
+#endif
 
   bool isSpecialKey = key == KEY_PTT || key == KEY_SIDE1 || key == KEY_SIDE2;
   return gSettings.keylock && (gSettings.pttLock || !isSpecialKey);
@@ -282,7 +292,7 @@ static bool keyAction(AppAction_t act) {
 
   case KA_PRO_MODE:
     gSettings.iAmPro = !gSettings.iAmPro;
-    SETTINGS_Save();
+    SETTINGS_DelayedSave();
     return true;
 
   // ========================================================================
@@ -513,6 +523,9 @@ static bool checkInt(void) {
 }
 
 void SYS_Main(void) {
+  // полная скорость флеша — пока сканер не меряет
+  PY25Q16_SetQuietFn(SCAN_IsRfQuiet);
+
   LogC(LOG_C_BRIGHT_WHITE, "Keyboard init");
   keyboard_init(onKey);
   keyboard_tick_1ms();
@@ -536,7 +549,7 @@ void SYS_Main(void) {
   for (;;) {
     uint32_t now = Now();  // Read once per loop — fewer TIM2 accesses
 
-    SETTINGS_UpdateSave();
+    PERSIST_Update();
     checkInt();
     SCAN_Check();
 
@@ -581,6 +594,12 @@ void SYS_Main(void) {
 
     appRender();
 
-    __WFI();
+    // момент замера будит ядро прерыванием TIM2. Если оно пришло, пока мы
+    // рисовали, — не засыпаем до тика SysTick. WFI при запрещённых
+    // прерываниях всё равно просыпается по ожидающему IRQ.
+    __disable_irq();
+    if (!SCAN_IsSampleDue())
+      __WFI();
+    __enable_irq();
   }
 }
@@ -4,6 +4,7 @@
 #include "../helper/keymap.h"
 #include "../helper/measurements.h"
 #include "../helper/menu.h"
+#include "../helper/persist.h"
 #include "../radio.h"
 #include "../settings.h"
 #include "graphics.h"
@@ -12,6 +13,8 @@
 
 bool gKeymapActive;
 
+#define KEYMAP_SAVE_DELAY_MS 1000
+
 static const uint8_t ITEM_H = 19;
 
 typedef enum { KM_KEYS, KM_ACTIONS } KmState;
@@ -241,7 +244,7 @@ static bool subAction(uint16_t index, KEY_Code_t key, Key_State_t state) {
     MENU_Deinit();
     kmState = KM_KEYS;
     MENU_Init(&menu);
-    KEYMAP_Save();
+    PERSIST_Mark(KEYMAP_Save, KEYMAP_SAVE_DELAY_MS);
     return true;
   }
 
@@ -277,7 +280,7 @@ void KEYMAP_Show(void) {
 }
 
 void KEYMAP_Hide(void) {
-  KEYMAP_Save();
+  PERSIST_Mark(KEYMAP_Save, KEYMAP_SAVE_DELAY_MS);
   gKeymapActive = false;
   kmState = KM_KEYS;
   MENU_Deinit();
@@ -287,12 +287,10 @@ static bool action(const uint16_t index, KEY_Code_t key, Key_State_t state) {
       sort(SORT_F);
       return true;
     case KEY_SIDE1:
-      loot->whitelist = false;
-      loot->blacklist = !loot->blacklist;
+      LOOT_ToggleBlacklist(loot);
       return true;
     case KEY_SIDE2:
-      loot->blacklist = false;
-      loot->whitelist = !loot->whitelist;
+      LOOT_ToggleWhitelist(loot);
       return true;
     case KEY_7:
       shortList = !shortList;
@@ -361,8 +359,7 @@ static bool action(const uint16_t index, KEY_Code_t key, Key_State_t state) {
 
 static void cbSetLootFreq(uint32_t f, uint32_t _) {
   (void)_;
-  Loot *loot = LOOT_Item(gEditLootIndex);
-  loot->f = f;
+  gEditLootIndex = LOOT_SetFrequency(gEditLootIndex, f);
   gEditMode = EDIT_MODE_ACTIVE;
   gFInputActive = false;
   gRedrawScreen = true;
@@ -9,7 +9,7 @@ uint8_t gTextInputSize = 15;
 bool gTextInputActive;
 void (*gTextInputCallback)(void);
 
-static const char *letters[9] = {
+static const char *const letters[9] = {
     "",
     "abc",  // 2
     "def",  // 3
@@ -21,7 +21,7 @@ static const char *letters[9] = {
     "wxyz"  // 9
 };
 
-static const char *lettersCapital[9] = {
+static const char *const lettersCapital[9] = {
     "",
     "ABC",  // 2
     "DEF",  // 3
@@ -33,9 +33,9 @@ static const char *lettersCapital[9] = {
     "WXYZ"  // 9
 };
 
-static const char *numbers[10] = {"1", "2", "3", "4", "5",
+static const char *const numbers[10] = {"1", "2", "3", "4", "5",
                                   "6", "7", "8", "9", "0"};
-static const char *symbols[9] = {
+static const char *const symbols[9] = {
     "",
     ".,!?:;",   // 2
     "()[]<>{}", // 3
@@ -47,7 +47,7 @@ static const char *symbols[9] = {
     ""          // 9
 };
 
-static const char **currentSet = lettersCapital;
+static const char *const *currentSet = lettersCapital;
 static const char *currentRow;
 static char inputField[16] = {0};
 static uint8_t inputIndex = 0;